@@ -22,16 +22,20 @@ LOCAL_SRC_FILES := $(SDL_PATH)/src/main/android/SDL_android_main.c \
 	../../../../../../src/AStarContainer.cpp \
 	../../../../../../src/AStarNode.cpp \
 	../../../../../../src/Avatar.cpp \
+	../../../../../../src/AvatarCompositeCache.cpp \
 	../../../../../../src/BehaviorStandard.cpp \
 	../../../../../../src/CampaignManager.cpp \
 	../../../../../../src/CombatText.cpp \
 	../../../../../../src/CursorManager.cpp \
+	../../../../../../src/DataCache.cpp \
 	../../../../../../src/DeviceList.cpp \
 	../../../../../../src/EffectManager.cpp \
 	../../../../../../src/Enemy.cpp \
 	../../../../../../src/EnemyBehavior.cpp \
 	../../../../../../src/EnemyGroupManager.cpp \
 	../../../../../../src/EnemyManager.cpp \
+	../../../../../../src/EnemyPerception.cpp \
+	../../../../../../src/EventIndex.cpp \
 	../../../../../../src/EventManager.cpp \
 	../../../../../../src/FileParser.cpp \
 	../../../../../../src/FontEngine.cpp \
@@ -49,9 +53,11 @@ LOCAL_SRC_FILES := $(SDL_PATH)/src/main/android/SDL_android_main.c \
 	../../../../../../src/Hazard.cpp \
 	../../../../../../src/HazardManager.cpp \
 	../../../../../../src/IconManager.cpp \
+	../../../../../../src/ImageCache.cpp \
 	../../../../../../src/InputState.cpp \
 	../../../../../../src/ItemManager.cpp \
 	../../../../../../src/ItemStorage.cpp \
+	../../../../../../src/JobSystem.cpp \
 	../../../../../../src/Loot.cpp \
 	../../../../../../src/LootManager.cpp \
 	../../../../../../src/Map.cpp \
@@ -90,7 +96,9 @@ LOCAL_SRC_FILES := $(SDL_PATH)/src/main/android/SDL_android_main.c \
 	../../../../../../src/SaveLoad.cpp \
 	../../../../../../src/SDLInputState.cpp \
 	../../../../../../src/SDLHardwareRenderDevice.cpp \
+	../../../../../../src/SDLSoftwareBlitter.cpp \
 	../../../../../../src/SDLSoftwareRenderDevice.cpp \
+	../../../../../../src/SDLSoftwareTileRenderer.cpp \
 	../../../../../../src/SDLSoundManager.cpp \
 	../../../../../../src/SDLFontEngine.cpp \
 	../../../../../../src/Settings.cpp \
@@ -98,6 +106,7 @@ LOCAL_SRC_FILES := $(SDL_PATH)/src/main/android/SDL_android_main.c \
 	../../../../../../src/SharedResources.cpp \
 	../../../../../../src/StatBlock.cpp \
 	../../../../../../src/Stats.cpp \
+	../../../../../../src/TextureAtlas.cpp \
 	../../../../../../src/TileSet.cpp \
 	../../../../../../src/TooltipData.cpp \
 	../../../../../../src/Utils.cpp \
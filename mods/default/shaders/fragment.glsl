@@ -9,10 +9,14 @@ uniform sampler2D texture;
 uniform sampler2D normals;
 uniform bool lightEnabled;
 
+uniform sampler2D lightmap;
+uniform bool lightmapEnabled;
+
 uniform int screenWidth;
 uniform int screenHeight;
 
 varying vec2 texcoord;
+varying vec2 screencoord;
 
 void main()
 {
@@ -51,4 +55,9 @@ void main()
 	{
         gl_FragColor = texture2D(texture, texcoord);
 	}
+
+	if (lightmapEnabled)
+	{
+		gl_FragColor.rgb *= texture2D(lightmap, screencoord).rgb;
+	}
 }
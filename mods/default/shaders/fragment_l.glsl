@@ -0,0 +1,16 @@
+#version 100
+
+#ifdef GL_ES
+precision mediump float;
+precision mediump int;
+#endif
+
+uniform vec4 lightColor;
+
+varying vec2 local;
+
+void main()
+{
+	float falloff = clamp(1.0 - length(local), 0.0, 1.0);
+	gl_FragColor = vec4(lightColor.rgb * falloff * falloff, 1.0);
+}
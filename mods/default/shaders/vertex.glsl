@@ -7,6 +7,7 @@ uniform vec4 offset;
 uniform vec4 texelOffset;
 
 varying vec2 texcoord;
+varying vec2 screencoord;
 
 void main()
 {
@@ -23,4 +24,7 @@ void main()
 	}
     texcoord.x = (position.x * 0.5 + 0.5) / texelOffset.x + texelOffset.y;
     texcoord.y = (position.y * 0.5 + 0.5) / texelOffset.z + texelOffset.w;
+
+	// position in the light map
+	screencoord = gl_Position.xy * 0.5 + 0.5;
 }
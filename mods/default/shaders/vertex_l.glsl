@@ -0,0 +1,14 @@
+#version 100
+
+attribute vec2 position;
+
+// center (x, y) and radius (z, w) of the light
+uniform vec4 lightRect;
+
+varying vec2 local;
+
+void main()
+{
+	local = position;
+	gl_Position = vec4(lightRect.xy + position * lightRect.zw, 0.0, 1.0);
+}
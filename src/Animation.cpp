@@ -252,6 +252,15 @@ void Animation::advanceFrame() {
 
 Renderable Animation::getCurrentFrame(int kind) {
 	Renderable r;
+	getCurrentFrame(kind, r);
+	return r;
+}
+
+/**
+ * Write the current frame into r, e.g. a new slot at the end of a render queue
+ * Fields that aren't part of the frame are left as they are.
+ */
+void Animation::getCurrentFrame(int kind, Renderable& r) {
 	if (!frames.empty()) {
 		const int index = (max_kinds*frames[cur_frame_index]) + kind;
 		r.src.x = gfx[index].x;
@@ -263,7 +272,6 @@ Renderable Animation::getCurrentFrame(int kind) {
 		r.image = sprite;
 		r.blend_mode = blend_mode;
 	}
-	return r;
 }
 
 void Animation::reset() {
@@ -328,6 +336,15 @@ void Animation::setActiveFrames(const std::vector<short> &_active_frames) {
 	}
 }
 
+void Animation::setFrameRects(const std::vector<Rect>& _gfx) {
+	if (_gfx.size() == gfx.size())
+		gfx = _gfx;
+}
+
+void Animation::setSprite(Image* _sprite) {
+	sprite = _sprite;
+}
+
 bool Animation::isFirstFrame() {
 	return cur_frame_index == 0;
 }
@@ -114,6 +114,7 @@ public:
 
 	// return the Renderable of the current frame
 	Renderable getCurrentFrame(int direction);
+	void getCurrentFrame(int direction, Renderable& r);
 
 	bool isFirstFrame();
 	bool isLastFrame();
@@ -139,6 +140,11 @@ public:
 
 	unsigned getFrameCount() { return frame_count; }
 
+	// used to move the frames to a TextureAtlas page after loading
+	const std::vector<Rect>& getFrameRects() { return gfx; }
+	void setFrameRects(const std::vector<Rect>& _gfx);
+	void setSprite(Image* _sprite);
+
 	void setSpeed(float val);
 };
 
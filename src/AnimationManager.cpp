@@ -92,4 +92,6 @@ void AnimationManager::cleanUp() {
 		}
 		--i;
 	}
+
+	atlas.cleanUp();
 }
@@ -21,6 +21,7 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 
 #include "AnimationSet.h"
 #include "CommonIncludes.h"
+#include "TextureAtlas.h"
 
 class AnimationManager {
 private:
@@ -40,6 +41,8 @@ public:
 	void decreaseCount(const std::string &name);
 	void increaseCount(const std::string &name);
 	void cleanUp();
+
+	TextureAtlas atlas;
 };
 
 #endif // __ANIMATION_MANAGER__
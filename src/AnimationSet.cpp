@@ -110,13 +110,14 @@ void AnimationSet::load() {
 		if (parser.section.empty()) {
 			if (parser.key == "image") {
 				// @ATTR image|filename|Filename of sprite-sheet image.
-				if (sprite != NULL) {
+				if (!imagefile.empty()) {
 					parser.error("AnimationSet: Multiple images specified. Dragons be here!");
 					mods->resetModConfig();
 					Exit(128);
 				}
 
-				sprite = render_device->loadImage(parser.val);
+				// loaded once all frames are known, see loadSpriteSheet()
+				imagefile = parser.val;
 			}
 			else if (parser.key == "render_size") {
 				// @ATTR render_size|int, int : Width, Height|Width and height of animation.
@@ -227,6 +228,8 @@ void AnimationSet::load() {
 		animations.push_back(a);
 	}
 
+	loadSpriteSheet();
+
 	if (starting_animation != "") {
 		Animation *a = getAnimation(starting_animation);
 		delete defaultAnimation;
@@ -234,6 +237,42 @@ void AnimationSet::load() {
 	}
 }
 
+/**
+ * Put the used frames of the sprite-sheet into the texture atlas if possible,
+ * otherwise load the sprite-sheet as a separate image
+ */
+void AnimationSet::loadSpriteSheet() {
+	if (imagefile.empty())
+		return;
+
+	if (TEXTURE_ATLAS) {
+		std::vector<Rect> frames;
+		for (size_t i = 0; i < animations.size(); ++i) {
+			const std::vector<Rect>& anim_frames = animations[i]->getFrameRects();
+			frames.insert(frames.end(), anim_frames.begin(), anim_frames.end());
+		}
+
+		sprite = anim->atlas.add(imagefile, frames);
+
+		if (sprite) {
+			std::vector<Rect>::iterator it = frames.begin();
+			for (size_t i = 0; i < animations.size(); ++i) {
+				std::vector<Rect>::iterator next = it + animations[i]->getFrameRects().size();
+				animations[i]->setSprite(sprite);
+				animations[i]->setFrameRects(std::vector<Rect>(it, next));
+				it = next;
+			}
+			return;
+		}
+	}
+
+	sprite = render_device->loadImage(imagefile);
+
+	for (size_t i = 0; i < animations.size(); ++i) {
+		animations[i]->setSprite(sprite);
+	}
+}
+
 AnimationSet::~AnimationSet() {
 	if (sprite) sprite->unref();
 	for (unsigned i = 0; i < animations.size(); ++i)
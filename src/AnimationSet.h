@@ -39,6 +39,7 @@ private:
 	AnimationSet *parent;
 
 	void load();
+	void loadSpriteSheet();
 	unsigned getAnimationFrames(const std::string &_name);
 
 public:
@@ -94,7 +94,7 @@ Avatar::Avatar()
 		infile.close();
 	}
 
-	loadStepFX(stats.sfx_step);
+	loadStepFX(stats.def->sfx_step);
 }
 
 void Avatar::init() {
@@ -203,6 +203,8 @@ void Avatar::loadLayerDefinitions() {
 
 void Avatar::loadGraphics(std::vector<Layer_gfx> _img_gfx) {
 
+	composite_cache.clear();
+
 	for (unsigned int i=0; i<animsets.size(); i++) {
 		if (animsets[i])
 			anim->decreaseCount(animsets[i]->getName());
@@ -235,7 +237,7 @@ void Avatar::loadGraphics(std::vector<Layer_gfx> _img_gfx) {
  * Walking/running steps sound depends on worn armor
  */
 void Avatar::loadStepFX(const std::string& stepname) {
-	std::string filename = stats.sfx_step;
+	std::string filename = stats.def->sfx_step;
 	if (stepname != "") {
 		filename = stepname;
 	}
@@ -730,6 +732,7 @@ void Avatar::logic(std::vector<ActionData> &action_queue, bool restrict_power_us
 void Avatar::transform() {
 	// calling a transform power locks the actionbar, so we unlock it here
 	inpt->unlockActionBar();
+	composite_cache.clear();
 
 	delete charmed_stats;
 	charmed_stats = NULL;
@@ -798,6 +801,7 @@ void Avatar::transform() {
 void Avatar::untransform() {
 	// calling a transform power locks the actionbar, so we unlock it here
 	inpt->unlockActionBar();
+	composite_cache.clear();
 
 	// For timed transformations, move the player to the last valid tile when untransforming
 	mapr->collider.unblock(stats.pos.x, stats.pos.y);
@@ -853,7 +857,7 @@ void Avatar::untransform() {
 	}
 
 	loadSounds();
-	loadStepFX(stats.sfx_step);
+	loadStepFX(stats.def->sfx_step);
 
 	delete charmed_stats;
 	delete hero_stats;
@@ -894,34 +898,46 @@ void Avatar::resetActiveAnimation() {
 }
 
 void Avatar::addRenders(std::vector<Renderable> &r) {
+	const FPoint render_pos = getRenderPos();
+
 	if (!stats.transformed) {
+		layer_renders.clear();
 		for (unsigned i = 0; i < layer_def[stats.direction].size(); ++i) {
 			unsigned index = layer_def[stats.direction][i];
 			if (anims[index]) {
-				Renderable ren = anims[index]->getCurrentFrame(stats.direction);
-				ren.map_pos = stats.pos;
+				layer_renders.resize(layer_renders.size()+1);
+				Renderable& ren = layer_renders.back();
+				anims[index]->getCurrentFrame(stats.direction, ren);
+				ren.map_pos = render_pos;
 				ren.prio = i+1;
 				ren.color_mod = stats.effects.getCurrentColor();
 				ren.alpha_mod = stats.effects.getCurrentAlpha();
-				r.push_back(ren);
 			}
 		}
+
+		r.resize(r.size()+1);
+		if (!composite_cache.compose(layer_renders, r.back())) {
+			r.pop_back();
+			r.insert(r.end(), layer_renders.begin(), layer_renders.end());
+		}
 	}
 	else {
-		Renderable ren = activeAnimation->getCurrentFrame(stats.direction);
-		ren.map_pos = stats.pos;
+		r.resize(r.size()+1);
+		Renderable& ren = r.back();
+		activeAnimation->getCurrentFrame(stats.direction, ren);
+		ren.map_pos = render_pos;
 		ren.color_mod = stats.effects.getCurrentColor();
 		ren.alpha_mod = stats.effects.getCurrentAlpha();
-		r.push_back(ren);
 	}
 	// add effects
 	for (unsigned i = 0; i < stats.effects.effect_list.size(); ++i) {
 		if (stats.effects.effect_list[i].animation && !stats.effects.effect_list[i].animation->isCompleted()) {
-			Renderable ren = stats.effects.effect_list[i].animation->getCurrentFrame(0);
-			ren.map_pos = stats.pos;
+			r.resize(r.size()+1);
+			Renderable& ren = r.back();
+			stats.effects.effect_list[i].animation->getCurrentFrame(0, ren);
+			ren.map_pos = render_pos;
 			if (stats.effects.effect_list[i].render_above) ren.prio = layer_def[stats.direction].size()+1;
 			else ren.prio = 0;
-			r.push_back(ren);
 		}
 	}
 }
@@ -931,6 +947,8 @@ void Avatar::logMsg(const std::string& str, bool prevent_spam) {
 }
 
 Avatar::~Avatar() {
+	composite_cache.clear();
+
 	if (stats.transformed && charmed_stats && charmed_stats->animations != "") {
 		anim->decreaseCount(charmed_stats->animations);
 	}
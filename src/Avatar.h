@@ -27,6 +27,7 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #ifndef AVATAR_H
 #define AVATAR_H
 
+#include "AvatarCompositeCache.h"
 #include "CommonIncludes.h"
 #include "Entity.h"
 #include "PowerManager.h"
@@ -84,6 +85,9 @@ private:
 	std::vector<AnimationSet*> animsets; // hold the animations for all equipped items in the right order of drawing.
 	std::vector<Animation*> anims; // hold the animations for all equipped items in the right order of drawing.
 
+	AvatarCompositeCache composite_cache; // equipment layers of each frame, pre-rendered into a single image
+	std::vector<Renderable> layer_renders;
+
 	short body;
 
 	bool transform_triggered;
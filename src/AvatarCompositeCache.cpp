@@ -0,0 +1,172 @@
+/*
+Copyright © 2016 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+#include "AvatarCompositeCache.h"
+#include "RenderDevice.h"
+#include "SharedResources.h"
+#include "Settings.h"
+
+AvatarCompositeCache::AvatarCompositeCache()
+	: ticks(0) {
+}
+
+AvatarCompositeCache::~AvatarCompositeCache() {
+	clear();
+}
+
+void AvatarCompositeCache::release(AvatarComposite& composite) {
+	for (size_t i = 0; i < composite.layers.size(); ++i) {
+		composite.layers[i].image->unref();
+	}
+	if (composite.image)
+		composite.image->unref();
+}
+
+/**
+ * Drop all composites, e.g. when the equipment changes
+ */
+void AvatarCompositeCache::clear() {
+	for (size_t i = 0; i < composites.size(); ++i) {
+		release(composites[i]);
+	}
+	composites.clear();
+}
+
+AvatarComposite* AvatarCompositeCache::find(const std::vector<Renderable>& layers) {
+	for (size_t i = 0; i < composites.size(); ++i) {
+		const std::vector<AvatarCompositeLayer>& key = composites[i].layers;
+		if (key.size() != layers.size())
+			continue;
+
+		bool match = true;
+		for (size_t j = 0; j < key.size() && match; ++j) {
+			const Renderable& r = layers[j];
+			match = key[j].image == r.image &&
+					key[j].src.x == r.src.x && key[j].src.y == r.src.y && key[j].src.w == r.src.w && key[j].src.h == r.src.h &&
+					key[j].offset.x == r.offset.x && key[j].offset.y == r.offset.y;
+		}
+
+		if (match)
+			return &composites[i];
+	}
+
+	return NULL;
+}
+
+void AvatarCompositeCache::evict() {
+	size_t oldest = 0;
+	for (size_t i = 1; i < composites.size(); ++i) {
+		if (composites[i].last_used < composites[oldest].last_used)
+			oldest = i;
+	}
+
+	release(composites[oldest]);
+	composites.erase(composites.begin() + oldest);
+}
+
+/**
+ * Render the layers, in order, into a new image that covers all of them
+ */
+AvatarComposite* AvatarCompositeCache::create(const std::vector<Renderable>& layers) {
+	// bounds of the layers, relative to the map position they are drawn at
+	int left = 0;
+	int top = 0;
+	int right = 0;
+	int bottom = 0;
+
+	for (size_t i = 0; i < layers.size(); ++i) {
+		const Renderable& r = layers[i];
+		if (i == 0 || -r.offset.x < left) left = -r.offset.x;
+		if (i == 0 || -r.offset.y < top) top = -r.offset.y;
+		if (i == 0 || r.src.w - r.offset.x > right) right = r.src.w - r.offset.x;
+		if (i == 0 || r.src.h - r.offset.y > bottom) bottom = r.src.h - r.offset.y;
+	}
+
+	if (right <= left || bottom <= top)
+		return NULL;
+
+	Image* image = render_device->createImage(right - left, bottom - top);
+	if (!image)
+		return NULL;
+
+	for (size_t i = 0; i < layers.size(); ++i) {
+		Rect src = layers[i].src;
+		Rect dest;
+		dest.x = -layers[i].offset.x - left;
+		dest.y = -layers[i].offset.y - top;
+		dest.w = src.w;
+		dest.h = src.h;
+		render_device->renderToImage(layers[i].image, src, image, dest);
+	}
+
+	while (!composites.empty() && composites.size() >= static_cast<size_t>(AVATAR_CACHE)) {
+		evict();
+	}
+
+	AvatarComposite composite;
+	composite.image = image;
+	composite.offset.x = -left;
+	composite.offset.y = -top;
+	composite.last_used = ticks;
+
+	composite.layers.resize(layers.size());
+	for (size_t i = 0; i < layers.size(); ++i) {
+		composite.layers[i].image = layers[i].image;
+		composite.layers[i].src = layers[i].src;
+		composite.layers[i].offset = layers[i].offset;
+		layers[i].image->ref();
+	}
+
+	composites.push_back(composite);
+	return &composites.back();
+}
+
+/**
+ * Replace a stack of layers with a single Renderable
+ * The map position, prio and color/alpha mods are taken from the first layer.
+ * Returns false if the layers can't be cached; they should then be drawn as they are.
+ */
+bool AvatarCompositeCache::compose(const std::vector<Renderable>& layers, Renderable& out) {
+	if (AVATAR_CACHE <= 0 || layers.empty())
+		return false;
+
+	for (size_t i = 0; i < layers.size(); ++i) {
+		// additive layers blend with whatever is behind the avatar, so they can't be baked in
+		if (!layers[i].image || layers[i].blend_mode != RENDERABLE_BLEND_NORMAL)
+			return false;
+	}
+
+	++ticks;
+
+	AvatarComposite* composite = find(layers);
+	if (!composite)
+		composite = create(layers);
+	if (!composite)
+		return false;
+
+	composite->last_used = ticks;
+
+	out = layers[0];
+	out.image = composite->image;
+	out.src.x = 0;
+	out.src.y = 0;
+	out.src.w = composite->image->getWidth();
+	out.src.h = composite->image->getHeight();
+	out.offset = composite->offset;
+
+	return true;
+}
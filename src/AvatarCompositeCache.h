@@ -0,0 +1,70 @@
+/*
+Copyright © 2016 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+/**
+ * class AvatarCompositeCache
+ *
+ * The paper-doll avatar is drawn as one Renderable per equipment layer. This
+ * cache renders the layer stack of a frame into a single image the first time
+ * it is seen, so that the avatar can be drawn with one blit afterwards.
+ *
+ * Entries are keyed by the image, source rectangle and offset of every layer,
+ * and hold a reference to those images so that a key can't be mistaken for a
+ * new image at the same address. The least recently used entries are dropped
+ * once AVATAR_CACHE entries are stored.
+ */
+
+#ifndef AVATAR_COMPOSITE_CACHE_H
+#define AVATAR_COMPOSITE_CACHE_H
+
+#include "CommonIncludes.h"
+#include "Utils.h"
+
+class AvatarCompositeLayer {
+public:
+	Image* image;
+	Rect src;
+	Point offset;
+};
+
+class AvatarComposite {
+public:
+	std::vector<AvatarCompositeLayer> layers;
+	Image* image;
+	Point offset;
+	unsigned last_used;
+};
+
+class AvatarCompositeCache {
+private:
+	AvatarComposite* find(const std::vector<Renderable>& layers);
+	AvatarComposite* create(const std::vector<Renderable>& layers);
+	void evict();
+	void release(AvatarComposite& composite);
+
+	std::vector<AvatarComposite> composites;
+	unsigned ticks;
+
+public:
+	AvatarCompositeCache();
+	~AvatarCompositeCache();
+
+	void clear();
+	bool compose(const std::vector<Renderable>& layers, Renderable& out);
+};
+
+#endif
@@ -53,31 +53,16 @@ void BehaviorAlly::findTarget() {
 		hero_dist = 0;
 	}
 
-	bool enemies_in_combat = false;
 	//enter combat because enemy is targeting the player or a summon
-	for (unsigned int i=0; i < enemies->enemies.size(); i++) {
-		if(enemies->enemies[i]->stats.in_combat && !enemies->enemies[i]->stats.hero_ally) {
-			Enemy* enemy = enemies->enemies[i];
-
-			//now work out the distance to the enemy and compare it to the distance to the current targer (we want to target the closest enemy)
-			if(enemies_in_combat) {
-				float enemy_dist = calcDist(e->stats.pos, enemy->stats.pos);
-				if (enemy_dist < target_dist) {
-					pursue_pos.x = enemy->stats.pos.x;
-					pursue_pos.y = enemy->stats.pos.y;
-					target_dist = enemy_dist;
-				}
-			}
-			else {
-				//minion is not already chasig another enemy so chase this one
-				pursue_pos.x = enemy->stats.pos.x;
-				pursue_pos.y = enemy->stats.pos.y;
-				target_dist = calcDist(e->stats.pos, enemy->stats.pos);
-			}
-
-			e->stats.in_combat = true;
-			enemies_in_combat = true;
-		}
+	//we want to target the closest enemy
+	float enemy_dist = 0;
+	Enemy* enemy = enemies->perception.getNearestHostile(e->stats.pos, enemy_dist);
+	bool enemies_in_combat = (enemy != NULL);
+	if (enemy) {
+		pursue_pos.x = enemy->stats.pos.x;
+		pursue_pos.y = enemy->stats.pos.y;
+		target_dist = enemy_dist;
+		e->stats.in_combat = true;
 	}
 
 
@@ -98,7 +83,7 @@ void BehaviorAlly::findTarget() {
 
 	// check line-of-sight
 	if (target_dist < e->stats.threat_range && pc->stats.alive)
-		los = mapr->collider.line_of_sight(e->stats.pos.x, e->stats.pos.y, pursue_pos.x, pursue_pos.y);
+		los = enemies->perception.lineOfSight(e->stats.pos, pursue_pos);
 	else
 		los = false;
 
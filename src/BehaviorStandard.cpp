@@ -26,6 +26,8 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include "UtilsMath.h"
 #include "SharedGameResources.h"
 
+#include <limits>
+
 BehaviorStandard::BehaviorStandard(Enemy *_e)
 	: EnemyBehavior(_e)
 	, path()
@@ -33,6 +35,11 @@ BehaviorStandard::BehaviorStandard(Enemy *_e)
 	, collided(false)
 	, path_found(false)
 	, chance_calc_path(0)
+	, path_requested(false)
+	, path_request_target()
+	, path_result()
+	, path_result_found(false)
+	, path_result_ready(false)
 	, hero_dist(0)
 	, target_dist(0)
 	, pursue_pos(-1, -1)
@@ -41,6 +48,7 @@ BehaviorStandard::BehaviorStandard(Enemy *_e)
 	, move_to_safe_dist(false)
 	, flee_ticks(0)
 	, flee_cooldown(0)
+	, skipped_ticks(0)
 {
 }
 
@@ -64,6 +72,7 @@ void BehaviorStandard::logic() {
 			return;
 	}
 
+	catchUp();
 	doUpkeep();
 	findTarget();
 	checkPower();
@@ -73,6 +82,91 @@ void BehaviorStandard::logic() {
 	fleeing = false;
 }
 
+/**
+ * A frame without AI, for enemies far away from the hero
+ * Idle enemies only count the skipped frames. Everything else keeps its stats
+ * up to date every frame, so that regeneration and effects are not changed.
+ */
+void BehaviorStandard::skipLogic() {
+	if (e->stats.corpse) {
+		if (e->stats.corpse_ticks > 0)
+			e->stats.corpse_ticks--;
+		return;
+	}
+
+	if (!e->stats.hero_ally && !e->stats.encountered)
+		return;
+
+	if (isIdle()) {
+		skipped_ticks++;
+		return;
+	}
+
+	catchUp();
+	doUpkeep();
+}
+
+/**
+ * An enemy is idle if doUpkeep() would do nothing but count down its timers
+ */
+bool BehaviorStandard::isIdle() {
+	StatBlock& stats = e->stats;
+
+	if (!stats.alive || stats.in_combat || stats.join_combat || stats.hero_ally)
+		return false;
+
+	// regeneration and out of combat healing
+	if (stats.hp != stats.get(STAT_HP_MAX))
+		return false;
+	if (stats.mp < stats.get(STAT_MP_MAX) && stats.get(STAT_MP_REGEN) > 0)
+		return false;
+
+	if (stats.charge_speed != 0.0f || stats.teleportation || !stats.party_buffs.empty())
+		return false;
+
+	// passive powers that are activated every frame
+	if (stats.effects.triggered_hit || stats.effects.triggered_block)
+		return false;
+
+	// timed effects, including damage and healing over time
+	for (size_t i = 0; i < stats.effects.effect_list.size(); ++i) {
+		if (stats.effects.effect_list[i].duration > 0)
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * A waiting enemy stands still out of combat, until the hero enters its aggro zone
+ * Patrolling enemies aren't waiting, since their movement depends on the hero's distance.
+ */
+bool BehaviorStandard::isWaiting() {
+	const StatBlock& stats = e->stats;
+	return stats.alive && !stats.hero_ally && !stats.in_combat && !stats.join_combat && stats.combat_style != COMBAT_AGGRESSIVE && stats.waypoints.empty() && !stats.hero_in_aggro_zone;
+}
+
+/**
+ * Count down the timers for the frames skipped while idle
+ */
+void BehaviorStandard::catchUp() {
+	if (skipped_ticks == 0)
+		return;
+
+	StatBlock& stats = e->stats;
+
+	stats.cooldown_ticks = std::max(stats.cooldown_ticks - skipped_ticks, 0);
+	stats.cooldown_hit_ticks = std::max(stats.cooldown_hit_ticks - skipped_ticks, 0);
+	stats.state_ticks = std::max(stats.state_ticks - skipped_ticks, 0);
+	stats.waypoint_pause_ticks = std::max(stats.waypoint_pause_ticks - skipped_ticks, 0);
+
+	for (size_t i = 0; i < stats.powers_ai.size(); ++i) {
+		stats.powers_ai[i].ticks = std::max(stats.powers_ai[i].ticks - skipped_ticks, 0);
+	}
+
+	skipped_ticks = 0;
+}
+
 /**
  * Various upkeep on stats
  * TODO: some of these actions could be moved to StatBlock::logic()
@@ -135,6 +229,19 @@ void BehaviorStandard::doUpkeep() {
 	}
 }
 
+/**
+ * Compute the path requested by checkMove() in the last frame
+ * Paths are computed here, so that EnemyManager can compute them for several enemies at once.
+ */
+void BehaviorStandard::prepareLogic() {
+	if (!path_requested)
+		return;
+
+	path_result_found = mapr->collider.compute_path(e->stats.pos, path_request_target, path_result, e->stats.movement_type);
+	path_requested = false;
+	path_result_ready = true;
+}
+
 /**
  * Locate the player and set various targeting info
  */
@@ -145,10 +252,13 @@ void BehaviorStandard::findTarget() {
 	if (e->stats.effects.stun) return;
 
 	// check distance and line of sight between enemy and hero
-	if (pc->stats.alive)
-		hero_dist = calcDist(e->stats.pos, pc->stats.pos);
-	else
+	// enemies that wait for the hero to enter their aggro zone need neither
+	if (!pc->stats.alive)
 		hero_dist = 0;
+	else if (isWaiting())
+		hero_dist = std::numeric_limits<float>::max();
+	else
+		hero_dist = calcDist(e->stats.pos, pc->stats.pos);
 
 
 	// aggressive enemies are always in combat
@@ -157,7 +267,9 @@ void BehaviorStandard::findTarget() {
 	}
 
 	// check entering combat (because the player got too close)
-	if (e->stats.alive && !e->stats.in_combat && los && hero_dist < stealth_threat_range && e->stats.combat_style != COMBAT_PASSIVE) {
+	// the aggro zones of EnemyPerception hold the distance check, a dead hero is at distance 0
+	bool hero_in_range = (pc->stats.alive ? e->stats.hero_in_aggro_zone : stealth_threat_range > 0);
+	if (e->stats.alive && !e->stats.in_combat && los && hero_in_range && e->stats.combat_style != COMBAT_PASSIVE) {
 		e->stats.join_combat = true;
 	}
 
@@ -199,16 +311,11 @@ void BehaviorStandard::findTarget() {
 
 	//if there are player allies closer than the hero, target an ally instead
 	if(e->stats.in_combat) {
-		for (unsigned int i=0; i < enemies->enemies.size(); i++) {
-			if(!enemies->enemies[i]->stats.corpse && enemies->enemies[i]->stats.hero_ally) {
-				//now work out the distance to the minion and compare it to the distance to the current targer (we want to target the closest ally)
-				float ally_dist = calcDist(e->stats.pos, enemies->enemies[i]->stats.pos);
-				if (ally_dist < target_dist) {
-					pursue_pos.x = enemies->enemies[i]->stats.pos.x;
-					pursue_pos.y = enemies->enemies[i]->stats.pos.y;
-					target_dist = ally_dist;
-				}
-			}
+		float ally_dist = 0;
+		Enemy* ally = enemies->perception.getNearestAlly(e->stats.pos, target_dist, ally_dist);
+		if (ally) {
+			pursue_pos = ally->stats.pos;
+			target_dist = ally_dist;
 		}
 	}
 
@@ -228,7 +335,7 @@ void BehaviorStandard::findTarget() {
 
 	// check line-of-sight
 	if (target_dist < e->stats.threat_range && pc->stats.alive)
-		los = mapr->collider.line_of_sight(e->stats.pos.x, e->stats.pos.y, pc->stats.pos.x, pc->stats.pos.y);
+		los = enemies->perception.lineOfSight(e->stats.pos, pc->stats.pos);
 	else
 		los = false;
 
@@ -398,13 +505,21 @@ void BehaviorStandard::checkMove() {
 
 				prev_target = pursue_pos;
 
-				// target first waypoint
 				if(recalculate_path) {
 					chance_calc_path = -100;
-					path.clear();
-					path_found = mapr->collider.compute_path(e->stats.pos, pursue_pos, path, e->stats.movement_type);
+					path_requested = true;
+					path_request_target = pursue_pos;
 				}
 
+				// the path requested in the last frame replaces the old one
+				if(path_result_ready) {
+					path.swap(path_result);
+					path_found = path_result_found;
+					path_result_ready = false;
+				}
+
+				// target first waypoint
+
 				if(!path.empty()) {
 					pursue_pos = path.back();
 
@@ -415,6 +530,8 @@ void BehaviorStandard::checkMove() {
 			}
 			else {
 				path.clear();
+				path_requested = false;
+				path_result_ready = false;
 			}
 
 			if (e->stats.charge_speed == 0.0f) {
@@ -30,6 +30,9 @@ private:
 
 	// logic steps
 	void doUpkeep();
+	bool isIdle();
+	bool isWaiting();
+	void catchUp();
 	virtual void findTarget();
 	void checkPower();
 	void checkMove();
@@ -46,6 +49,13 @@ protected:
 	bool path_found;
 	int chance_calc_path;
 
+	// paths are computed in prepareLogic(), at the start of the frame after they were requested
+	bool path_requested;
+	FPoint path_request_target;
+	std::vector<FPoint> path_result;
+	bool path_result_found;
+	bool path_result_ready;
+
 	float hero_dist;
 	float target_dist;
 	FPoint pursue_pos;
@@ -57,9 +67,14 @@ protected:
 	int flee_ticks;
 	int flee_cooldown;
 
+	// frames skipped by skipLogic() while idle, for which the timers still have to be counted down
+	int skipped_ticks;
+
 public:
 	explicit BehaviorStandard(Enemy *_e);
 	void logic();
+	void skipLogic();
+	void prepareLogic();
 
 };
 
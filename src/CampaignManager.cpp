@@ -26,6 +26,7 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 
 #include "CampaignManager.h"
 #include "CommonIncludes.h"
+#include "DataCache.h"
 #include "Menu.h"
 #include "MenuManager.h"
 #include "MenuInventory.h"
@@ -37,7 +38,9 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 
 CampaignManager::CampaignManager()
 	: status()
-	, bonus_xp(0.0) {
+	, bonus_xp(0.0)
+	, state_version(1)
+	, state_hash(0) {
 }
 
 /**
@@ -65,15 +68,37 @@ std::string CampaignManager::getAll() {
 	return ss.str();
 }
 
+/**
+ * Statuses are given a numeric id the first time they are used, so that event conditions can check them quickly
+ */
+int CampaignManager::getStatusID(const std::string& s) {
+	std::map<std::string, int>::iterator it = status_ids.find(s);
+	if (it != status_ids.end())
+		return it->second;
+
+	int id = static_cast<int>(status_flags.size());
+	status_ids[s] = id;
+	status_flags.push_back(false);
+	return id;
+}
+
 bool CampaignManager::checkStatus(const std::string& s) {
 
 	// avoid searching empty statuses
 	if (s == "") return false;
 
-	for (unsigned int i=0; i < status.size(); i++) {
-		if (status[i] == s) return true;
-	}
-	return false;
+	std::map<std::string, int>::iterator it = status_ids.find(s);
+	if (it == status_ids.end())
+		return false;
+
+	return status_flags[it->second];
+}
+
+bool CampaignManager::checkStatusID(int id) {
+	if (id < 0 || static_cast<size_t>(id) >= status_flags.size())
+		return false;
+
+	return status_flags[id];
 }
 
 void CampaignManager::setStatus(const std::string& s) {
@@ -85,7 +110,9 @@ void CampaignManager::setStatus(const std::string& s) {
 	if (checkStatus(s)) return;
 
 	status.push_back(s);
+	status_flags[getStatusID(s)] = true;
 	pc->stats.check_title = true;
+	changeState();
 }
 
 void CampaignManager::unsetStatus(const std::string& s) {
@@ -99,12 +126,20 @@ void CampaignManager::unsetStatus(const std::string& s) {
 		--it;
 		if ((*it) == s) {
 			it = status.erase(it);
+			status_flags[getStatusID(s)] = false;
+			changeState();
 			return;
 		}
 		pc->stats.check_title = true;
 	}
 }
 
+void CampaignManager::clearStatus() {
+	status.clear();
+	status_flags.assign(status_flags.size(), false);
+	changeState();
+}
+
 bool CampaignManager::checkCurrency(int quantity) {
 	return menu->inv->inventory[CARRIED].contain(CURRENCY_ID, quantity);
 }
@@ -123,6 +158,7 @@ void CampaignManager::removeCurrency(int quantity) {
 		menu->inv->removeCurrency(max_amount);
 		pc->logMsg(msg->get("%d %s removed.", max_amount, CURRENCY), false);
 		items->playSound(CURRENCY_ID);
+		changeState();
 	}
 }
 
@@ -132,6 +168,7 @@ void CampaignManager::removeItem(int item_id) {
 	if (menu->inv->remove(item_id)) {
 		pc->logMsg(msg->get("%s removed.", items->getItemName(item_id)), false);
 		items->playSound(item_id);
+		changeState();
 	}
 }
 
@@ -140,6 +177,7 @@ void CampaignManager::rewardItem(ItemStack istack) {
 		return;
 
 	menu->inv->add(istack, CARRIED, -1, true, true);
+	changeState();
 
 	if (istack.item != CURRENCY_ID) {
 		if (istack.quantity <= 1)
@@ -243,5 +281,87 @@ bool CampaignManager::checkAllRequirements(const Event_Component& ec) {
 	return false;
 }
 
+bool CampaignManager::checkAllConditions(const std::vector<EventCondition>& conditions) {
+	for (size_t i=0; i<conditions.size(); ++i) {
+		const EventCondition& cond = conditions[i];
+		bool met = true;
+
+		switch (cond.type) {
+			case EC_REQUIRES_STATUS:
+				met = checkStatusID(cond.id);
+				break;
+			case EC_REQUIRES_NOT_STATUS:
+				met = !checkStatusID(cond.id);
+				break;
+			case EC_REQUIRES_CURRENCY:
+				met = checkCurrency(cond.id);
+				break;
+			case EC_REQUIRES_NOT_CURRENCY:
+				met = !checkCurrency(cond.id);
+				break;
+			case EC_REQUIRES_ITEM:
+				met = checkItem(cond.id);
+				break;
+			case EC_REQUIRES_NOT_ITEM:
+				met = !checkItem(cond.id);
+				break;
+			case EC_REQUIRES_LEVEL:
+				met = pc->stats.level >= cond.id;
+				break;
+			case EC_REQUIRES_NOT_LEVEL:
+				met = pc->stats.level < cond.id;
+				break;
+			case EC_REQUIRES_CLASS:
+				met = pc->stats.character_class == cond.s;
+				break;
+			case EC_REQUIRES_NOT_CLASS:
+				met = pc->stats.character_class != cond.s;
+				break;
+			default:
+				break;
+		}
+
+		if (!met)
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * The inventory and hero stats are changed from many places, so instead of tracking each change,
+ * compare a hash of everything event conditions depend on. Called once per frame by GameStatePlay
+ * and when a map is entered or left. Changes made by events themselves go through the functions
+ * above, which call changeState() right away.
+ */
+void CampaignManager::checkStateChange() {
+	if (!menu || !menu->inv || !pc)
+		return;
+
+	uint64_t hash = hashData(&pc->stats.level, sizeof(pc->stats.level));
+	hash = hashString(pc->stats.character_class, hash);
+
+	for (int area = EQUIPMENT; area <= CARRIED; ++area) {
+		ItemStorage& storage = menu->inv->inventory[area];
+		for (int i=0; i<storage.getSlotNumber(); ++i) {
+			hash = hashData(&storage.storage[i].item, sizeof(storage.storage[i].item), hash);
+			hash = hashData(&storage.storage[i].quantity, sizeof(storage.storage[i].quantity), hash);
+		}
+	}
+
+	if (hash != state_hash) {
+		state_hash = hash;
+		changeState();
+	}
+}
+
+void CampaignManager::changeState() {
+	++state_version;
+
+	// 0 is reserved for "never checked"
+	if (state_version == 0)
+		state_version = 1;
+}
+
 CampaignManager::~CampaignManager() {
 }
@@ -29,6 +29,8 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include "CommonIncludes.h"
 #include "ItemManager.h"
 
+#include <stdint.h>
+
 class StatBlock;
 
 class CampaignManager {
@@ -38,9 +40,12 @@ public:
 
 	void setAll(const std::string& s);
 	std::string getAll();
+	int getStatusID(const std::string& s);
 	bool checkStatus(const std::string& s);
+	bool checkStatusID(int id);
 	void setStatus(const std::string& s);
 	void unsetStatus(const std::string& s);
+	void clearStatus();
 	bool checkCurrency(int quantity);
 	bool checkItem(int item_id);
 	void removeCurrency(int quantity);
@@ -50,11 +55,22 @@ public:
 	void rewardXP(int amount, bool show_message);
 	void restoreHPMP(const std::string& s);
 	bool checkAllRequirements(const Event_Component& ec);
+	bool checkAllConditions(const std::vector<EventCondition>& conditions);
+	void checkStateChange();
 
 	std::vector<std::string> status;
 	std::queue<ItemStack> drop_stack;
 
 	float bonus_xp;		// Fractional XP points not yet awarded (e.g. killing 1 XP enemies with a +25% ring)
+
+	unsigned state_version; // changes whenever anything an event condition can check has changed
+
+private:
+	void changeState();
+
+	std::map<std::string, int> status_ids;
+	std::vector<bool> status_flags; // indexed by status id
+	uint64_t state_hash; // inventory, level and class as of the last checkStateChange()
 };
 
 
@@ -29,17 +29,27 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include "CombatText.h"
 #include "CommonIncludes.h"
 #include "FileParser.h"
+#include "FontEngine.h"
+#include "RenderDevice.h"
 #include "Settings.h"
 #include "SharedResources.h"
 #include "UtilsParsing.h"
+#include "WidgetLabel.h"
+
+Combat_Text_Cache_Entry::Combat_Text_Cache_Entry()
+	: sprite(NULL)
+	, refs(0)
+{}
 
 Combat_Text_Item::Combat_Text_Item()
-	: label(NULL)
-	, lifespan(0)
+	: lifespan(0)
 	, pos(FPoint())
 	, floating_offset(0)
 	, text("")
 	, displaytype(0)
+	, is_number(false)
+	, cache_key("")
+	, scr_pos(Point())
 {}
 
 Combat_Text_Item::~Combat_Text_Item() {
@@ -52,6 +62,12 @@ CombatText::CombatText() {
 	msg_color[COMBAT_MESSAGE_BUFF] = font->getColor("combat_buff");
 	msg_color[COMBAT_MESSAGE_MISS] = font->getColor("combat_miss");
 
+	for (int i = 0; i < 5; ++i) {
+		for (int j = 0; j < COMBAT_TEXT_GLYPHS; ++j) {
+			glyphs[i][j] = NULL;
+		}
+	}
+
 	duration = MAX_FRAMES_PER_SEC; // 1 second
 	speed = 60.f / MAX_FRAMES_PER_SEC;
 	offset = 48; // average height of flare-game enemies, so a sensible default
@@ -82,28 +98,147 @@ CombatText::CombatText() {
 }
 
 CombatText::~CombatText() {
-	// delete all messages
-	while (combat_text.size() > 0) {
-		delete combat_text.begin()->label;
-		combat_text.erase(combat_text.begin());
+	clear();
+
+	for (int i = 0; i < 5; ++i) {
+		for (int j = 0; j < COMBAT_TEXT_GLYPHS; ++j) {
+			if (glyphs[i][j])
+				delete glyphs[i][j];
+		}
+	}
+
+	std::map<std::string, Combat_Text_Cache_Entry>::iterator it;
+	for (it = text_cache.begin(); it != text_cache.end(); ++it) {
+		if (it->second.sprite)
+			delete it->second.sprite;
+	}
+}
+
+/**
+ * Render a string to a new sprite, the same way WidgetLabel does
+ */
+Sprite* CombatText::createTextSprite(const std::string& text, const Color& color) {
+	font->setFont("font_regular");
+	int w = font->calc_width(text);
+	int h = font->getFontHeight();
+	if (w <= 0 || h <= 0)
+		return NULL;
+
+	Image *image = render_device->createImage(w, h);
+	if (!image)
+		return NULL;
+
+	font->renderShadowed(text, 0, 0, JUSTIFY_LEFT, image, 0, color);
+	Sprite *sprite = image->createSprite();
+	image->unref();
+
+	return sprite;
+}
+
+/**
+ * Numbers are composed from one sprite per digit, which are only rendered the first time they're used
+ */
+Sprite* CombatText::getGlyph(int displaytype, char c) {
+	int index;
+	if (c >= '0' && c <= '9')
+		index = c - '0';
+	else if (c == '-')
+		index = 10;
+	else
+		return NULL;
+
+	if (!glyphs[displaytype][index])
+		glyphs[displaytype][index] = createTextSprite(std::string(1, c), msg_color[displaytype]);
+
+	return glyphs[displaytype][index];
+}
+
+/**
+ * Reuse the slot of an expired message if possible
+ */
+Combat_Text_Item* CombatText::getFreeItem() {
+	size_t index;
+	if (!free_items.empty()) {
+		index = free_items.back();
+		free_items.pop_back();
+	}
+	else {
+		index = combat_text.size();
+		combat_text.push_back(Combat_Text_Item());
+	}
+
+	active_items.push_back(index);
+	return &combat_text[index];
+}
+
+void CombatText::releaseItem(size_t index) {
+	Combat_Text_Item& c = combat_text[index];
+
+	if (!c.is_number) {
+		std::map<std::string, Combat_Text_Cache_Entry>::iterator it = text_cache.find(c.cache_key);
+		if (it != text_cache.end())
+			it->second.refs--;
+	}
+
+	c.lifespan = 0;
+	free_items.push_back(index);
+}
+
+/**
+ * Delete cached text sprites that aren't displayed anymore
+ * Text like "+5 HP" has many variations, so the cache is kept from growing indefinitely
+ */
+void CombatText::trimCache() {
+	if (text_cache.size() <= COMBAT_TEXT_CACHE_SIZE)
+		return;
+
+	std::map<std::string, Combat_Text_Cache_Entry>::iterator it = text_cache.begin();
+	while (it != text_cache.end()) {
+		if (it->second.refs <= 0) {
+			if (it->second.sprite)
+				delete it->second.sprite;
+			text_cache.erase(it++);
+		}
+		else {
+			++it;
+		}
 	}
 }
 
 void CombatText::addString(const std::string& message, const FPoint& location, int displaytype) {
 	if (COMBAT_TEXT) {
-		Combat_Text_Item *c = new Combat_Text_Item();
-		WidgetLabel *label = new WidgetLabel();
+		if (displaytype < 0 || displaytype >= 5 || duration <= 0)
+			return;
+
+		bool is_number = !message.empty();
+		for (size_t i = 0; i < message.length(); ++i) {
+			if (!((message[i] >= '0' && message[i] <= '9') || (i == 0 && message[i] == '-'))) {
+				is_number = false;
+				break;
+			}
+		}
+
+		Combat_Text_Item *c = getFreeItem();
 		c->pos.x = location.x;
 		c->pos.y = location.y;
 		c->floating_offset = static_cast<float>(offset);
-		c->label = label;
 		c->text = message;
 		c->lifespan = duration;
 		c->displaytype = displaytype;
+		c->is_number = is_number;
+		c->cache_key.clear();
+		c->scr_pos = map_to_screen(c->pos.x, c->pos.y, cam.x, cam.y);
 
-		c->label->set(static_cast<int>(c->pos.x), static_cast<int>(c->pos.y), JUSTIFY_CENTER, VALIGN_BOTTOM, c->text, msg_color[c->displaytype]);
-		combat_text.push_back(*c);
-		delete c;
+		if (!is_number) {
+			std::stringstream ss;
+			ss << displaytype << ":" << message;
+			c->cache_key = ss.str();
+
+			Combat_Text_Cache_Entry& entry = text_cache[c->cache_key];
+			if (!entry.sprite)
+				entry.sprite = createTextSprite(message, msg_color[displaytype]);
+			entry.refs++;
+		}
 	}
 }
 
@@ -118,34 +253,70 @@ void CombatText::addInt(int num, const FPoint& location, int displaytype) {
 void CombatText::logic(const FPoint& _cam) {
 	cam = _cam;
 
-	for(std::vector<Combat_Text_Item>::iterator it = combat_text.begin(); it != combat_text.end(); ++it) {
-		it->lifespan--;
-		it->floating_offset += speed;
+	size_t active_count = 0;
+	for (size_t i = 0; i < active_items.size(); ++i) {
+		Combat_Text_Item& c = combat_text[active_items[i]];
 
-		Point scr_pos;
-		scr_pos = map_to_screen(it->pos.x, it->pos.y, cam.x, cam.y);
-		scr_pos.y -= static_cast<int>(it->floating_offset);
+		c.lifespan--;
+		c.floating_offset += speed;
 
-		it->label->setX(scr_pos.x);
-		it->label->setY(scr_pos.y);
-	}
+		c.scr_pos = map_to_screen(c.pos.x, c.pos.y, cam.x, cam.y);
+		c.scr_pos.y -= static_cast<int>(c.floating_offset);
 
-	// delete expired messages
-	while (combat_text.size() && combat_text.begin()->lifespan <= 0) {
-		delete combat_text.begin()->label;
-		combat_text.erase(combat_text.begin());
+		// expired messages are put back in the pool, the others keep their order
+		if (c.lifespan <= 0)
+			releaseItem(active_items[i]);
+		else
+			active_items[active_count++] = active_items[i];
 	}
+	active_items.resize(active_count);
+
+	trimCache();
 }
 
 void CombatText::render() {
 	if (!SHOW_HUD) return;
 
-	for(std::vector<Combat_Text_Item>::iterator it = combat_text.begin(); it != combat_text.end(); ++it) {
-		if (it->lifespan > 0)
-			it->label->render();
+	// newer messages are drawn over older ones
+	for (size_t i = 0; i < active_items.size(); ++i) {
+		Combat_Text_Item& c = combat_text[active_items[i]];
+
+		if (c.is_number) {
+			// centered horizontally, bottom aligned
+			int width = 0;
+			int height = 0;
+			for (size_t j = 0; j < c.text.length(); ++j) {
+				Sprite *glyph = getGlyph(c.displaytype, c.text[j]);
+				if (glyph) {
+					width += glyph->getGraphicsWidth();
+					height = std::max(height, glyph->getGraphicsHeight());
+				}
+			}
+
+			int x = c.scr_pos.x - width/2;
+			for (size_t j = 0; j < c.text.length(); ++j) {
+				Sprite *glyph = getGlyph(c.displaytype, c.text[j]);
+				if (glyph) {
+					glyph->setDest(x, c.scr_pos.y - height);
+					render_device->render(glyph);
+					x += glyph->getGraphicsWidth();
+				}
+			}
+		}
+		else {
+			std::map<std::string, Combat_Text_Cache_Entry>::iterator it = text_cache.find(c.cache_key);
+			if (it != text_cache.end() && it->second.sprite) {
+				Sprite *sprite = it->second.sprite;
+				sprite->setDest(c.scr_pos.x - sprite->getGraphicsWidth()/2, c.scr_pos.y - sprite->getGraphicsHeight());
+				render_device->render(sprite);
+			}
+		}
 	}
 }
 
 void CombatText::clear() {
-	combat_text.clear();
+	for (size_t i = 0; i < active_items.size(); ++i) {
+		releaseItem(active_items[i]);
+	}
+	active_items.clear();
 }
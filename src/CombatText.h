@@ -30,7 +30,6 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 
 #include "CommonIncludes.h"
 #include "Utils.h"
-#include "WidgetLabel.h"
 
 #define COMBAT_MESSAGE_GIVEDMG 0
 #define COMBAT_MESSAGE_TAKEDMG 1
@@ -38,19 +37,35 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #define COMBAT_MESSAGE_MISS 3
 #define COMBAT_MESSAGE_BUFF 4
 
-class WidgetLabel;
+// number of characters that have their own cached sprite: 0-9 and '-'
+const int COMBAT_TEXT_GLYPHS = 11;
+
+// cached text sprites that are not in use are deleted once there are more than this many
+const size_t COMBAT_TEXT_CACHE_SIZE = 32;
+
+class Sprite;
+
+class Combat_Text_Cache_Entry {
+public:
+	Combat_Text_Cache_Entry();
+
+	Sprite *sprite;
+	int refs;
+};
 
 class Combat_Text_Item {
 public:
 	Combat_Text_Item();
 	~Combat_Text_Item();
 
-	WidgetLabel *label;
 	int lifespan;
 	FPoint pos;
 	float floating_offset;
 	std::string text;
 	int displaytype;
+	bool is_number; // numbers are drawn from the per-digit sprites, other text uses cache_key
+	std::string cache_key;
+	Point scr_pos;
 };
 
 class CombatText {
@@ -65,8 +80,21 @@ public:
 	void clear();
 
 private:
+	Combat_Text_Item* getFreeItem();
+	void releaseItem(size_t index);
+	Sprite* createTextSprite(const std::string& text, const Color& color);
+	Sprite* getGlyph(int displaytype, char c);
+	void trimCache();
+
 	FPoint cam;
+
+	// items are never erased, expired items are put back on the free list and reused
 	std::vector<Combat_Text_Item> combat_text;
+	std::vector<size_t> free_items;
+	std::vector<size_t> active_items; // oldest first, which is the order they are drawn in
+
+	Sprite *glyphs[5][COMBAT_TEXT_GLYPHS];
+	std::map<std::string, Combat_Text_Cache_Entry> text_cache;
 
 	Color msg_color[5];
 	int duration;
@@ -0,0 +1,97 @@
+/*
+Copyright © 2016 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+/**
+ * class CopyOnWrite
+ *
+ * Holds a value that is shared by all copies of the holder, until one of them
+ * changes it. Read through operator-> and operator*. write() gives a private
+ * copy of the value first if it is still shared.
+ *
+ * The reference count is not atomic. Holders may only be copied and destroyed
+ * on the main thread, but reading from jobs is fine.
+ */
+
+#ifndef COPY_ON_WRITE_H
+#define COPY_ON_WRITE_H
+
+template <typename T>
+class CopyOnWrite {
+private:
+	class Data {
+	public:
+		explicit Data(const T& _value)
+			: value(_value)
+			, refs(1) {
+		}
+
+		T value;
+		int refs;
+	};
+
+	void release() {
+		if (--data->refs == 0)
+			delete data;
+	}
+
+	Data* data;
+
+public:
+	CopyOnWrite()
+		: data(new Data(T())) {
+	}
+
+	CopyOnWrite(const CopyOnWrite& other)
+		: data(other.data) {
+		++data->refs;
+	}
+
+	~CopyOnWrite() {
+		release();
+	}
+
+	CopyOnWrite& operator=(const CopyOnWrite& other) {
+		if (data != other.data) {
+			++other.data->refs;
+			release();
+			data = other.data;
+		}
+		return *this;
+	}
+
+	const T& operator*() const {
+		return data->value;
+	}
+
+	const T* operator->() const {
+		return &data->value;
+	}
+
+	T& write() {
+		if (data->refs > 1) {
+			--data->refs;
+			data = new Data(data->value);
+		}
+		return data->value;
+	}
+
+	bool isShared() const {
+		return data->refs > 1;
+	}
+};
+
+#endif
@@ -0,0 +1,368 @@
+/*
+Copyright © 2016 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+#include "DataCache.h"
+#include "Settings.h"
+#include "SharedResources.h"
+#include "UtilsFileSystem.h"
+
+#include <cstring>
+
+// bump this whenever the layout of the cache file changes
+const uint32_t DATA_CACHE_VERSION = 1;
+const char DATA_CACHE_MAGIC[] = "FLAREDC";
+
+uint64_t hashData(const void* data, size_t length, uint64_t hash) {
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	for (size_t i = 0; i < length; ++i) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+uint64_t hashString(const std::string& s, uint64_t hash) {
+	// include the terminator so that "ab"+"c" and "a"+"bc" hash differently
+	return hashData(s.c_str(), s.length() + 1, hash);
+}
+
+/**
+ * Helpers for reading and writing the binary cache file.
+ * All values are written in the host byte order; the cache is never shared between machines.
+ */
+static void writeU32(std::ofstream& out, uint32_t val) {
+	out.write(reinterpret_cast<const char*>(&val), sizeof(val));
+}
+
+static void writeU64(std::ofstream& out, uint64_t val) {
+	out.write(reinterpret_cast<const char*>(&val), sizeof(val));
+}
+
+static void writeString(std::ofstream& out, const std::string& s) {
+	writeU32(out, static_cast<uint32_t>(s.length()));
+	out.write(s.data(), s.length());
+}
+
+class DataCacheReader {
+public:
+	const std::vector<char>& buf;
+	size_t pos;
+	bool ok;
+
+	explicit DataCacheReader(const std::vector<char>& _buf)
+		: buf(_buf)
+		, pos(0)
+		, ok(true) {
+	}
+
+	bool readRaw(void* dest, size_t length) {
+		if (!ok || length > buf.size() - pos) {
+			ok = false;
+			return false;
+		}
+		if (length > 0)
+			memcpy(dest, &buf[pos], length);
+		pos += length;
+		return true;
+	}
+
+	uint32_t readU32() {
+		uint32_t val = 0;
+		readRaw(&val, sizeof(val));
+		return val;
+	}
+
+	uint64_t readU64() {
+		uint64_t val = 0;
+		readRaw(&val, sizeof(val));
+		return val;
+	}
+
+	// element counts can't be larger than the remaining data, which protects against huge allocations
+	uint32_t readCount() {
+		uint32_t count = readU32();
+		if (count > buf.size() - pos) {
+			ok = false;
+			return 0;
+		}
+		return count;
+	}
+
+	std::string readString() {
+		uint32_t length = readU32();
+		if (!ok || length > buf.size() - pos) {
+			ok = false;
+			return "";
+		}
+		std::string s(&buf[0] + pos, length);
+		pos += length;
+		return s;
+	}
+};
+
+DataCacheFile::DataCacheFile()
+	: path("")
+	, size(0)
+	, mtime(0) {
+}
+
+DataCacheLine::DataCacheLine()
+	: new_section(false)
+	, file(0)
+	, line_number(0)
+	, section("")
+	, key("")
+	, val("") {
+}
+
+/**
+ * Add a file this entry depends on and return its index
+ */
+uint32_t DataCacheEntry::addFile(const std::string& path) {
+	for (size_t i = 0; i < files.size(); ++i) {
+		if (files[i].path == path)
+			return static_cast<uint32_t>(i);
+	}
+
+	DataCacheFile f;
+	f.path = path;
+	getFileInfo(path, f.size, f.mtime);
+	files.push_back(f);
+
+	return static_cast<uint32_t>(files.size() - 1);
+}
+
+DataCache::DataCache()
+	: cache_file(PATH_USER + "cache/data_cache.bin")
+	, key(0)
+	, dirty(false)
+	, hits(0)
+	, misses(0) {
+}
+
+DataCache::~DataCache() {
+}
+
+/**
+ * The cache as a whole is only usable with the same engine version and mod list
+ */
+uint64_t DataCache::calcKey() {
+	uint64_t hash = hashString(DATA_CACHE_MAGIC);
+	hash = hashData(&DATA_CACHE_VERSION, sizeof(DATA_CACHE_VERSION), hash);
+	hash = hashData(&VERSION_MAJOR, sizeof(VERSION_MAJOR), hash);
+	hash = hashData(&VERSION_MINOR, sizeof(VERSION_MINOR), hash);
+	hash = hashString(PATH_DATA, hash);
+	hash = hashString(CUSTOM_PATH_DATA, hash);
+
+	for (size_t i = 0; i < mods->mod_list.size(); ++i) {
+		hash = hashString(mods->mod_list[i].name, hash);
+	}
+
+	return hash;
+}
+
+bool DataCache::isValid(const DataCacheEntry& entry, const std::vector<std::string>& sources) {
+	// a mod file was added or removed
+	if (entry.sources != sources)
+		return false;
+
+	for (size_t i = 0; i < entry.files.size(); ++i) {
+		uint64_t size = 0;
+		uint64_t mtime = 0;
+		if (!getFileInfo(entry.files[i].path, size, mtime))
+			return false;
+		if (size != entry.files[i].size || mtime != entry.files[i].mtime)
+			return false;
+	}
+
+	return true;
+}
+
+void DataCache::load() {
+	entries.clear();
+	dirty = false;
+	key = calcKey();
+	hits = misses = 0;
+
+	std::ifstream infile(cache_file.c_str(), std::ios::in | std::ios::binary);
+	if (!infile.is_open())
+		return;
+
+	infile.seekg(0, std::ios::end);
+	std::streamoff length = infile.tellg();
+	infile.seekg(0, std::ios::beg);
+
+	if (length <= 0) {
+		infile.close();
+		return;
+	}
+
+	std::vector<char> buf(static_cast<size_t>(length));
+	infile.read(&buf[0], length);
+	bool read_ok = infile.good();
+	infile.close();
+
+	if (!read_ok)
+		return;
+
+	DataCacheReader reader(buf);
+
+	char magic[sizeof(DATA_CACHE_MAGIC)];
+	reader.readRaw(magic, sizeof(magic));
+	if (!reader.ok || memcmp(magic, DATA_CACHE_MAGIC, sizeof(magic)) != 0)
+		return;
+
+	// mod list or engine version changed, so none of the entries are usable
+	if (reader.readU64() != key) {
+		dirty = true;
+		return;
+	}
+
+	uint32_t entry_count = reader.readCount();
+	for (uint32_t i = 0; i < entry_count && reader.ok; ++i) {
+		std::string filename = reader.readString();
+		DataCacheEntry& entry = entries[filename];
+
+		entry.sources.resize(reader.readCount());
+		for (size_t j = 0; j < entry.sources.size() && reader.ok; ++j) {
+			entry.sources[j] = reader.readString();
+		}
+
+		entry.files.resize(reader.readCount());
+		for (size_t j = 0; j < entry.files.size() && reader.ok; ++j) {
+			entry.files[j].path = reader.readString();
+			entry.files[j].size = reader.readU64();
+			entry.files[j].mtime = reader.readU64();
+		}
+
+		entry.lines.resize(reader.readCount());
+		for (size_t j = 0; j < entry.lines.size() && reader.ok; ++j) {
+			DataCacheLine& line = entry.lines[j];
+			uint32_t flags = reader.readU32();
+			line.new_section = (flags & 1) != 0;
+			line.file = reader.readU32();
+			line.line_number = reader.readU32();
+			line.section = reader.readString();
+			line.key = reader.readString();
+			line.val = reader.readString();
+
+			if (line.file >= entry.files.size())
+				reader.ok = false;
+		}
+	}
+
+	if (!reader.ok) {
+		logError("DataCache: '%s' is corrupt. Game data will be parsed from text files.", cache_file.c_str());
+		entries.clear();
+		dirty = true;
+	}
+}
+
+void DataCache::save() {
+	if (hits + misses > 0)
+		logInfo("DataCache: %u of %u data files were read from the cache.", hits, hits + misses);
+
+	if (!dirty)
+		return;
+
+	// the mod list may have been changed in the config menu since load()
+	key = calcKey();
+
+	createDir(PATH_USER + "cache");
+
+	std::ofstream outfile(cache_file.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!outfile.is_open()) {
+		logError("DataCache: Unable to write '%s'.", cache_file.c_str());
+		return;
+	}
+
+	outfile.write(DATA_CACHE_MAGIC, sizeof(DATA_CACHE_MAGIC));
+	writeU64(outfile, key);
+	writeU32(outfile, static_cast<uint32_t>(entries.size()));
+
+	std::map<std::string, DataCacheEntry>::iterator it;
+	for (it = entries.begin(); it != entries.end(); ++it) {
+		const DataCacheEntry& entry = it->second;
+
+		writeString(outfile, it->first);
+
+		writeU32(outfile, static_cast<uint32_t>(entry.sources.size()));
+		for (size_t i = 0; i < entry.sources.size(); ++i) {
+			writeString(outfile, entry.sources[i]);
+		}
+
+		writeU32(outfile, static_cast<uint32_t>(entry.files.size()));
+		for (size_t i = 0; i < entry.files.size(); ++i) {
+			writeString(outfile, entry.files[i].path);
+			writeU64(outfile, entry.files[i].size);
+			writeU64(outfile, entry.files[i].mtime);
+		}
+
+		writeU32(outfile, static_cast<uint32_t>(entry.lines.size()));
+		for (size_t i = 0; i < entry.lines.size(); ++i) {
+			const DataCacheLine& line = entry.lines[i];
+			writeU32(outfile, line.new_section ? 1 : 0);
+			writeU32(outfile, line.file);
+			writeU32(outfile, line.line_number);
+			writeString(outfile, line.section);
+			writeString(outfile, line.key);
+			writeString(outfile, line.val);
+		}
+	}
+
+	if (outfile.bad())
+		logError("DataCache: Unable to write '%s'. No write access or disk is full!", cache_file.c_str());
+	else
+		dirty = false;
+
+	outfile.close();
+	outfile.clear();
+}
+
+void DataCache::clear() {
+	entries.clear();
+	dirty = true;
+}
+
+DataCacheEntry* DataCache::get(const std::string& filename, const std::vector<std::string>& sources) {
+	if (!DATA_CACHE)
+		return NULL;
+
+	std::map<std::string, DataCacheEntry>::iterator it = entries.find(filename);
+	if (it == entries.end()) {
+		++misses;
+		return NULL;
+	}
+
+	if (!isValid(it->second, sources)) {
+		entries.erase(it);
+		dirty = true;
+		++misses;
+		return NULL;
+	}
+
+	++hits;
+	return &(it->second);
+}
+
+void DataCache::store(const std::string& filename, const DataCacheEntry& entry) {
+	if (!DATA_CACHE)
+		return;
+
+	entries[filename] = entry;
+	dirty = true;
+}
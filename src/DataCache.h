@@ -0,0 +1,101 @@
+/*
+Copyright © 2016 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+/**
+ * class DataCache
+ *
+ * Stores the key/value stream produced by FileParser for game data files
+ * (items, powers, effects, enemies, loot tables, engine settings) in a single
+ * binary file in PATH_USER. On the next launch, FileParser::openCached() replays
+ * the stored stream instead of reading and tokenizing the text files again.
+ *
+ * This is a tokenizer-level cache: the managers still run their own parsing of
+ * each key/value pair, only the file reading and line splitting is skipped.
+ *
+ * The whole cache is keyed by the engine version and the active mod list. Each
+ * entry is additionally validated against the size and modification time of
+ * every file it was built from, so edited mod files are re-parsed as usual.
+ */
+
+#ifndef DATA_CACHE_H
+#define DATA_CACHE_H
+
+#include "CommonIncludes.h"
+#include <stdint.h>
+
+class DataCacheFile {
+public:
+	std::string path;
+	uint64_t size;
+	uint64_t mtime;
+
+	DataCacheFile();
+};
+
+class DataCacheLine {
+public:
+	bool new_section;
+	uint32_t file; // index into DataCacheEntry::files, used for error messages
+	uint32_t line_number;
+	std::string section;
+	std::string key;
+	std::string val;
+
+	DataCacheLine();
+};
+
+class DataCacheEntry {
+public:
+	std::vector<std::string> sources; // the result of ModManager::list() when this entry was built
+	std::vector<DataCacheFile> files; // every file that was read, including INCLUDEd files
+	std::vector<DataCacheLine> lines;
+
+	uint32_t addFile(const std::string& path);
+};
+
+class DataCache {
+private:
+	uint64_t calcKey();
+	bool isValid(const DataCacheEntry& entry, const std::vector<std::string>& sources);
+
+	std::string cache_file;
+	std::map<std::string, DataCacheEntry> entries;
+	uint64_t key;
+	bool dirty;
+
+	// how many files were replayed from the cache or parsed from text since load()
+	unsigned hits;
+	unsigned misses;
+
+public:
+	DataCache();
+	~DataCache();
+
+	void load();
+	void save();
+	void clear();
+
+	// Returns NULL if the cached entry is missing or out of date
+	DataCacheEntry* get(const std::string& filename, const std::vector<std::string>& sources);
+	void store(const std::string& filename, const DataCacheEntry& entry);
+};
+
+// FNV-1a, used to build stable on-disk cache keys
+uint64_t hashData(const void* data, size_t length, uint64_t hash = 14695981039346656037ULL);
+uint64_t hashString(const std::string& s, uint64_t hash = 14695981039346656037ULL);
+
+#endif
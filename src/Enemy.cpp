@@ -110,14 +110,28 @@ void Enemy::logic() {
 		eb = stats.hero_ally ? new BehaviorStandard(this) : new BehaviorAlly(this);
 		stats.converted = !stats.converted;
 		stats.hero_ally = !stats.hero_ally;
-		if (stats.convert_status != "") {
-			camp->setStatus(stats.convert_status);
+		if (stats.def->convert_status != "") {
+			camp->setStatus(stats.def->convert_status);
 		}
 	}
 
 	return;
 }
 
+/**
+ * A frame in which the AI of this enemy is skipped, see EnemyManager::logic()
+ */
+void Enemy::skipLogic() {
+	eb->skipLogic();
+}
+
+/**
+ * The read phase of a frame, see EnemyManager::logic()
+ */
+void Enemy::prepareLogic() {
+	eb->prepareLogic();
+}
+
 /**
  * Upon enemy death, handle rewards (currency, xp, loot)
  */
@@ -130,26 +144,26 @@ void Enemy::doRewards(int source_type) {
 	kill_source_type = source_type;
 
 	// some creatures create special loot if we're on a quest
-	if (stats.quest_loot_requires_status != "") {
+	if (stats.def->quest_loot_requires_status != "") {
 
 		// the loot manager will check quest_loot_id
 		// if set (not zero), the loot manager will 100% generate that loot.
-		if (!(camp->checkStatus(stats.quest_loot_requires_status) && !camp->checkStatus(stats.quest_loot_requires_not_status))) {
+		if (!(camp->checkStatus(stats.def->quest_loot_requires_status) && !camp->checkStatus(stats.def->quest_loot_requires_not_status))) {
 			stats.quest_loot_id = 0;
 		}
 	}
 
 	// some creatures drop special loot the first time they are defeated
 	// this must be done in conjunction with defeat status
-	if (stats.first_defeat_loot > 0) {
-		if (!camp->checkStatus(stats.defeat_status)) {
-			stats.quest_loot_id = stats.first_defeat_loot;
+	if (stats.def->first_defeat_loot > 0) {
+		if (!camp->checkStatus(stats.def->defeat_status)) {
+			stats.quest_loot_id = stats.def->first_defeat_loot;
 		}
 	}
 
 	// defeating some creatures (e.g. bosses) affects the story
-	if (stats.defeat_status != "") {
-		camp->setStatus(stats.defeat_status);
+	if (stats.def->defeat_status != "") {
+		camp->setStatus(stats.def->defeat_status);
 	}
 
 	loot->addEnemyLoot(this);
@@ -160,11 +174,9 @@ void Enemy::doRewards(int source_type) {
  * Map objects need to be drawn in Z order, so we allow a parent object (GameEngine)
  * to collect all mobile sprites each frame.
  */
-Renderable Enemy::getRender() {
-	Renderable r = activeAnimation->getCurrentFrame(stats.direction);
-	r.map_pos.x = stats.pos.x;
-	r.map_pos.y = stats.pos.y;
-	return r;
+void Enemy::getRender(Renderable& r) {
+	activeAnimation->getCurrentFrame(stats.direction, r);
+	r.map_pos = getRenderPos();
 }
 
 Enemy::~Enemy() {
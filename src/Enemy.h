@@ -39,12 +39,14 @@ public:
 	Enemy(const Enemy& e);
 	~Enemy();
 	void logic();
+	void skipLogic();
+	void prepareLogic();
 	unsigned char faceNextBest(float mapx, float mapy);
 	virtual void doRewards(int source_type);
 
 	std::string type;
 
-	Renderable getRender();
+	void getRender(Renderable& r);
 
 	Hazard *haz;
 	EnemyBehavior *eb;
@@ -33,6 +33,22 @@ void EnemyBehavior::logic() {
 
 }
 
+/**
+ * Called instead of logic() on the frames that EnemyManager skips for distant enemies
+ * Behaviors that don't support this just run their logic as usual.
+ */
+void EnemyBehavior::skipLogic() {
+	logic();
+}
+
+/**
+ * Called for every enemy before any of them runs logic(), possibly on a worker thread
+ * Only the state of this behavior may be changed here. Everything else, like the
+ * collision map and other enemies, can only be read.
+ */
+void EnemyBehavior::prepareLogic() {
+}
+
 EnemyBehavior::~EnemyBehavior() {
 
 }
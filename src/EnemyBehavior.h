@@ -38,6 +38,8 @@ public:
 	explicit EnemyBehavior(Enemy *_e);
 	virtual ~EnemyBehavior();
 	virtual void logic();
+	virtual void skipLogic();
+	virtual void prepareLogic();
 };
 
 #endif
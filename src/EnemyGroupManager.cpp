@@ -34,7 +34,7 @@ EnemyGroupManager::EnemyGroupManager() {
 		FileParser infile;
 
 		// @CLASS EnemyGroupManager|Description of enemies in enemies/
-		if (!infile.open(enemy_paths[i]))
+		if (!infile.openCached(enemy_paths[i]))
 			return;
 
 		Enemy_Level new_enemy;
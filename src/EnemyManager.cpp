@@ -31,11 +31,28 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 
 #include <limits>
 
+// AI level of detail: enemies beyond these distances (relative to ENCOUNTER_DIST) run their AI less often
+const float AI_LOD_REDUCED_DIST = 1.5f;
+const float AI_LOD_DORMANT_DIST = 3.f;
+const unsigned AI_LOD_REDUCED_INTERVAL = 4;
+const unsigned AI_LOD_DORMANT_INTERVAL = 16;
+
+// enemies per job of the read phase, small enough that threads which got cheap enemies can pick up more work
+const size_t ENEMY_CHUNK_SIZE = 8;
+
+void EnemyPrepareJob::run() {
+	for (size_t i = first; i < last; ++i) {
+		(*enemies)[i]->prepareLogic();
+	}
+}
+
 EnemyManager::EnemyManager()
 	: enemies()
+	, components()
 	, hero_stealth(0)
 	, player_blocked(false)
-	, player_blocked_ticks(0) {
+	, player_blocked_ticks(0)
+	, lod_ticks(0) {
 	handleNewMap();
 }
 
@@ -157,6 +174,7 @@ void EnemyManager::handleNewMap () {
 		e->stats.waypoints = me.waypoints;
 		e->stats.pos.x = me.pos.x;
 		e->stats.pos.y = me.pos.y;
+		e->prev_pos = e->stats.pos;
 		e->stats.direction = static_cast<unsigned char>(me.direction);
 		e->stats.wander = me.wander_radius > 0;
 		e->stats.setWanderArea(me.wander_radius);
@@ -177,6 +195,7 @@ void EnemyManager::handleNewMap () {
 		delete temp;
 
 		e->stats.pos = spawn_pos;
+		e->prev_pos = e->stats.pos;
 		e->stats.direction = pc->stats.direction;
 
 		enemies.push_back(e);
@@ -222,6 +241,8 @@ void EnemyManager::handleNewMap () {
 		}
 	}
 
+	syncComponents();
+
 	anim->cleanUp();
 }
 
@@ -237,6 +258,12 @@ void EnemyManager::handleSpawn() {
 		espawn = powers->map_enemies.front();
 		powers->map_enemies.pop();
 
+		Enemy_Level el = enemyg->getRandomEnemy(espawn.type, 0, 0);
+		if (el.type == "") {
+			logError("EnemyManager: Could not spawn creature type '%s'", espawn.type.c_str());
+			return;
+		}
+
 		Enemy *e = new Enemy();
 		// factory
 		if(espawn.hero_ally)
@@ -244,6 +271,10 @@ void EnemyManager::handleSpawn() {
 		else
 			e->eb = new BehaviorStandard(e);
 
+		// copying the stats of the prototype shares its definition, instead of loading the file again
+		e->stats = prototypes[loadEnemyPrototype(el.type)].stats;
+		e->type = el.type;
+
 		e->stats.hero_ally = espawn.hero_ally;
 		e->stats.enemy_ally = espawn.enemy_ally;
 		e->stats.summoned = true;
@@ -256,18 +287,6 @@ void EnemyManager::handleSpawn() {
 
 		e->stats.direction = static_cast<unsigned char>(espawn.direction);
 
-		Enemy_Level el = enemyg->getRandomEnemy(espawn.type, 0, 0);
-		e->type = el.type;
-
-		if (el.type != "") {
-			e->stats.load(el.type);
-		}
-		else {
-			logError("EnemyManager: Could not spawn creature type '%s'", espawn.type.c_str());
-			delete e;
-			return;
-		}
-
 		if (e->stats.animations != "") {
 			// load the animation file if specified
 			anim->increaseCount(e->stats.animations);
@@ -325,6 +344,8 @@ void EnemyManager::handleSpawn() {
 			e->stats.pos.x = pc->stats.pos.x;
 			e->stats.pos.y = pc->stats.pos.y;
 		}
+		// don't interpolate from the position of the prototype
+		e->prev_pos = e->stats.pos;
 		// special animation state for spawning enemies
 		e->stats.cur_state = ENEMY_SPAWN;
 
@@ -381,32 +402,76 @@ void EnemyManager::logic() {
 
 	handleSpawn();
 
-	std::vector<Enemy*>::iterator it;
-	for (it = enemies.begin(); it != enemies.end(); ++it) {
+	// gather the targets for all enemies at once
+	perception.update(enemies, hero_stealth);
+
+	// read phase: compute the paths that enemies asked for in the last frame
+	// nothing but the enemies themselves is changed here, so the results don't depend on the thread count
+	const size_t chunk_count = (enemies.size() + ENEMY_CHUNK_SIZE - 1) / ENEMY_CHUNK_SIZE;
+	prepare_jobs.resize(chunk_count);
+
+	JobCounter prepared;
+	for (size_t i = 0; i < chunk_count; ++i) {
+		prepare_jobs[i].enemies = &enemies;
+		prepare_jobs[i].first = i * ENEMY_CHUNK_SIZE;
+		prepare_jobs[i].last = std::min(prepare_jobs[i].first + ENEMY_CHUNK_SIZE, enemies.size());
+		job_system->run(&prepare_jobs[i], &prepared);
+	}
+	job_system->wait(&prepared);
+
+	lod_ticks++;
+
+	// commit phase: movement, collision and powers are applied in the order of the enemy list
+	for (size_t i = 0; i < enemies.size(); ++i) {
 		// new actions this round
-		(*it)->stats.hero_stealth = hero_stealth;
-		(*it)->logic();
+		enemies[i]->stats.hero_stealth = hero_stealth;
+		enemies[i]->stats.hero_in_aggro_zone = perception.isInAggroZone(i);
+
+		// stagger the frames of distant enemies, so that they don't all run their AI in the same frame
+		unsigned interval = getLogicInterval(enemies[i]);
+		if (interval <= 1 || (lod_ticks + i) % interval == 0)
+			enemies[i]->logic();
+		else
+			enemies[i]->skipLogic();
 	}
+
+	syncComponents();
 }
 
-Enemy* EnemyManager::enemyFocus(const Point& mouse, const FPoint& cam, bool alive_only) {
-	Point p;
-	Rect r;
-	for(unsigned int i = 0; i < enemies.size(); i++) {
-		if(alive_only && (enemies[i]->stats.cur_state == ENEMY_DEAD || enemies[i]->stats.cur_state == ENEMY_CRITDEAD)) {
-			continue;
-		}
-		p = map_to_screen(enemies[i]->stats.pos.x, enemies[i]->stats.pos.y, cam.x, cam.y);
+/**
+ * How often the AI of an enemy runs, in frames
+ * Enemies near the hero, in combat or allied with the hero run every frame.
+ */
+unsigned EnemyManager::getLogicInterval(Enemy* e) {
+	// enemies have to notice the hero right away
+	if (!AI_LOD || e->stats.hero_ally || e->stats.in_combat || e->stats.join_combat || e->stats.hero_in_aggro_zone || !pc->stats.alive)
+		return 1;
+
+	float dist = calcDist(e->stats.pos, pc->stats.pos);
+
+	if (dist <= ENCOUNTER_DIST * AI_LOD_REDUCED_DIST)
+		return 1;
+	else if (dist <= ENCOUNTER_DIST * AI_LOD_DORMANT_DIST)
+		return AI_LOD_REDUCED_INTERVAL;
+	else
+		return AI_LOD_DORMANT_INTERVAL;
+}
 
-		r.w = enemies[i]->getRender().src.w;
-		r.h = enemies[i]->getRender().src.h;
-		r.x = p.x - enemies[i]->getRender().offset.x;
-		r.y = p.y - enemies[i]->getRender().offset.y;
+/**
+ * The topmost enemy sprite under the mouse, as drawn in the last frame
+ */
+Enemy* EnemyManager::enemyFocus(const Point& mouse, bool alive_only) {
+	size_t cursor = mapr->getPickList().size();
+	while (const PickBounds* pb = mapr->pick(mouse, PICK_ENEMY, cursor)) {
+		// enemies are only removed on a new map, which also clears the pick list
+		if (pb->index >= enemies.size())
+			continue;
 
-		if (isWithinRect(r, mouse)) {
-			Enemy *enemy = enemies[i];
-			return enemy;
+		Enemy* enemy = enemies[pb->index];
+		if (alive_only && (enemy->stats.cur_state == ENEMY_DEAD || enemy->stats.cur_state == ENEMY_CRITDEAD)) {
+			continue;
 		}
+		return enemy;
 	}
 	return NULL;
 }
@@ -439,6 +504,55 @@ Enemy* EnemyManager::getNearestEnemy(const FPoint& pos, bool get_corpse, float *
 	return nearest;
 }
 
+/**
+ * Copy the hot fields of all enemies into the component arrays
+ * Called after anything that changes many enemies at once; code that changes a
+ * single enemy outside of logic(), like a hazard hit, syncs just that enemy.
+ */
+void EnemyManager::syncComponents() {
+	components.pos.resize(enemies.size());
+	components.hp.resize(enemies.size());
+	components.cur_state.resize(enemies.size());
+	components.alive.resize(enemies.size());
+	components.corpse.resize(enemies.size());
+	components.hero_ally.resize(enemies.size());
+
+	for (size_t i = 0; i < enemies.size(); ++i) {
+		syncComponents(i);
+	}
+}
+
+void EnemyManager::syncComponents(size_t index) {
+	const StatBlock& stats = enemies[index]->stats;
+	components.pos[index] = stats.pos;
+	components.hp[index] = stats.hp;
+	components.cur_state[index] = stats.cur_state;
+	components.alive[index] = stats.alive;
+	components.corpse[index] = stats.corpse;
+	components.hero_ally[index] = stats.hero_ally;
+}
+
+/**
+ * Approximate memory used by the enemies, for MenuDevHUD
+ * A definition shared by several enemies is only counted once.
+ */
+void EnemyManager::getMemoryUsage(size_t& enemy_bytes, size_t& definition_bytes, size_t& definition_count) {
+	std::set<const StatDefinition*> definitions;
+
+	enemy_bytes = 0;
+	definition_bytes = 0;
+
+	for (size_t i = 0; i < enemies.size(); ++i) {
+		enemy_bytes += sizeof(Enemy) - sizeof(StatBlock) + enemies[i]->stats.getMemoryUsage();
+
+		const StatDefinition* def = &(*enemies[i]->stats.def);
+		if (definitions.insert(def).second)
+			definition_bytes += def->getMemoryUsage();
+	}
+
+	definition_count = definitions.size();
+}
+
 /**
  * If an enemy has died, reward the hero with experience points
  */
@@ -460,7 +574,7 @@ bool EnemyManager::isCleared() {
 	if (enemies.empty()) return true;
 
 	for (unsigned int i=0; i < enemies.size(); i++) {
-		if (enemies[i]->stats.alive && !enemies[i]->stats.hero_ally)
+		if (components.alive[i] && !components.hero_ally[i])
 			return false;
 	}
 
@@ -485,26 +599,30 @@ void EnemyManager::spawn(const std::string& enemy_type, const Point& target) {
  * to collect all mobile sprites each frame.
  */
 void EnemyManager::addRenders(std::vector<Renderable> &r, std::vector<Renderable> &r_dead) {
-	std::vector<Enemy*>::iterator it;
-	for (it = enemies.begin(); it != enemies.end(); ++it) {
-		bool dead = (*it)->stats.corpse;
-		if (!dead || (*it)->stats.corpse_ticks > 0) {
-			Renderable re = (*it)->getRender();
-			re.prio = 1;
-			re.color_mod = (*it)->stats.effects.getCurrentColor();
-			re.alpha_mod = (*it)->stats.effects.getCurrentAlpha();
-
+	for (size_t i = 0; i < enemies.size(); ++i) {
+		Enemy* e = enemies[i];
+		bool dead = components.corpse[i];
+		if (!dead || e->stats.corpse_ticks > 0) {
 			// draw corpses below objects so that floor loot is more visible
-			(dead ? r_dead : r).push_back(re);
+			std::vector<Renderable>& queue = (dead ? r_dead : r);
+			queue.resize(queue.size()+1);
+			Renderable& re = queue.back();
+			e->getRender(re);
+			re.prio = 1;
+			re.color_mod = e->stats.effects.getCurrentColor();
+			re.alpha_mod = e->stats.effects.getCurrentAlpha();
+			re.pick_type = PICK_ENEMY;
+			re.pick_index = i;
 
 			// add effects
-			for (unsigned i = 0; i < (*it)->stats.effects.effect_list.size(); ++i) {
-				if ((*it)->stats.effects.effect_list[i].animation) {
-					Renderable ren = (*it)->stats.effects.effect_list[i].animation->getCurrentFrame(0);
-					ren.map_pos = (*it)->stats.pos;
-					if ((*it)->stats.effects.effect_list[i].render_above) ren.prio = 2;
+			for (unsigned j = 0; j < e->stats.effects.effect_list.size(); ++j) {
+				if (e->stats.effects.effect_list[j].animation) {
+					r.resize(r.size()+1);
+					Renderable& ren = r.back();
+					e->stats.effects.effect_list[j].animation->getCurrentFrame(0, ren);
+					ren.map_pos = e->getRenderPos();
+					if (e->stats.effects.effect_list[j].render_above) ren.prio = 2;
 					else ren.prio = 0;
-					r.push_back(ren);
 				}
 			}
 		}
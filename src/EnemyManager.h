@@ -28,13 +28,45 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 
 #include "Settings.h"
 #include "Enemy.h"
+#include "EnemyPerception.h"
+#include "JobSystem.h"
 #include "Utils.h"
 #include "CampaignManager.h"
 
+/**
+ * Runs the read phase of a chunk of enemies, see EnemyManager::logic()
+ */
+class EnemyPrepareJob : public Job {
+public:
+	std::vector<Enemy*>* enemies;
+	size_t first;
+	size_t last;
+
+	void run();
+};
+
+/**
+ * Copies of the enemy fields that are read every frame by most systems, stored
+ * one array per field so that loops over all enemies don't have to touch the
+ * rest of their StatBlock. Index i belongs to EnemyManager::enemies[i].
+ * The copies are written by EnemyManager::syncComponents(); the StatBlock stays
+ * the authoritative data.
+ */
+class EnemyComponents {
+public:
+	std::vector<FPoint> pos;
+	std::vector<int> hp;
+	std::vector<int> cur_state;
+	std::vector<bool> alive;
+	std::vector<bool> corpse;
+	std::vector<bool> hero_ally;
+};
+
 class EnemyManager {
 private:
 
 	void loadAnimations(Enemy *e);
+	unsigned getLogicInterval(Enemy* e);
 
 	std::vector<std::string> anim_prefixes;
 	std::vector<std::vector<Animation*> > anim_entities;
@@ -58,15 +90,25 @@ public:
 	void checkEnemiesforXP();
 	bool isCleared();
 	void spawn(const std::string& enemy_type, const Point& target);
-	Enemy *enemyFocus(const Point& mouse, const FPoint& cam, bool alive_only);
+	Enemy *enemyFocus(const Point& mouse, bool alive_only);
 	Enemy* getNearestEnemy(const FPoint& pos, bool get_corpse = false, float *saved_distance = NULL);
+	void syncComponents();
+	void syncComponents(size_t index);
+	void getMemoryUsage(size_t& enemy_bytes, size_t& definition_bytes, size_t& definition_count);
 
 	// vars
 	std::vector<Enemy*> enemies;
+	EnemyComponents components;
 	int hero_stealth;
 
 	bool player_blocked;
 	int player_blocked_ticks;
+
+	EnemyPerception perception;
+
+private:
+	unsigned lod_ticks;
+	std::vector<EnemyPrepareJob> prepare_jobs;
 };
 
 
@@ -0,0 +1,335 @@
+/*
+Copyright © 2016 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+#include "Avatar.h"
+#include "Enemy.h"
+#include "EnemyPerception.h"
+#include "MapRenderer.h"
+#include "SharedGameResources.h"
+
+#include <limits>
+
+// width and height of a bucket, in tiles
+const int PERCEPTION_BUCKET_SIZE = 8;
+
+// the cache is cleared once it holds this many sight lines
+const size_t SIGHT_CACHE_SIZE = 16384;
+
+/**
+ * The bucket column or row of a map coordinate, clamped to the grid
+ */
+static int getBucket(float v, int count) {
+	int bucket = (v < 0 ? 0 : static_cast<int>(v) / PERCEPTION_BUCKET_SIZE);
+	return std::min(bucket, count-1);
+}
+
+PerceptionGrid::PerceptionGrid()
+	: cols(0)
+	, rows(0) {
+}
+
+int PerceptionGrid::clampCol(float x) const {
+	return getBucket(x, cols);
+}
+
+int PerceptionGrid::clampRow(float y) const {
+	return getBucket(y, rows);
+}
+
+void PerceptionGrid::reset(int map_w, int map_h) {
+	cols = std::max(1, (map_w + PERCEPTION_BUCKET_SIZE - 1) / PERCEPTION_BUCKET_SIZE);
+	rows = std::max(1, (map_h + PERCEPTION_BUCKET_SIZE - 1) / PERCEPTION_BUCKET_SIZE);
+
+	targets.clear();
+
+	// keep the allocated buckets between frames, the map size rarely changes
+	buckets.resize(cols * rows);
+	for (size_t i = 0; i < buckets.size(); ++i) {
+		buckets[i].clear();
+	}
+}
+
+void PerceptionGrid::insert(Enemy* enemy) {
+	PerceptionTarget target;
+	target.enemy = enemy;
+	target.pos = enemy->stats.pos;
+
+	buckets[clampRow(target.pos.y) * cols + clampCol(target.pos.x)].push_back(targets.size());
+	targets.push_back(target);
+}
+
+/**
+ * Find the target closest to pos that is nearer than max_dist
+ * The buckets are searched in rings around pos, until no bucket left can hold
+ * a closer target. Of targets at the same distance, the first one in the enemy
+ * list is returned, like a plain search of the list would.
+ */
+Enemy* PerceptionGrid::getNearest(const FPoint& pos, float max_dist, float& dist) const {
+	if (targets.empty())
+		return NULL;
+
+	size_t nearest = targets.size();
+	float best = max_dist;
+
+	const int col = clampCol(pos.x);
+	const int row = clampRow(pos.y);
+	const int max_ring = std::max(std::max(col, cols-1-col), std::max(row, rows-1-row));
+
+	for (int ring = 0; ring <= max_ring; ++ring) {
+		// every bucket of this ring is at least this far away
+		if (ring > 0 && static_cast<float>((ring-1) * PERCEPTION_BUCKET_SIZE) > best)
+			break;
+
+		for (int r = std::max(row - ring, 0); r <= std::min(row + ring, rows-1); ++r) {
+			for (int c = std::max(col - ring, 0); c <= std::min(col + ring, cols-1); ++c) {
+				// inner buckets were searched in the previous rings
+				if (r != row - ring && r != row + ring && c != col - ring && c != col + ring)
+					continue;
+
+				const std::vector<size_t>& bucket = buckets[r * cols + c];
+				for (size_t i = 0; i < bucket.size(); ++i) {
+					const size_t index = bucket[i];
+					const float d = calcDist(pos, targets[index].pos);
+					if (d < best || (d == best && nearest < targets.size() && index < nearest)) {
+						best = d;
+						nearest = index;
+					}
+				}
+			}
+		}
+	}
+
+	if (nearest == targets.size())
+		return NULL;
+
+	dist = best;
+	return targets[nearest].enemy;
+}
+
+AggroZone::AggroZone()
+	: enemy(NULL)
+	, pos()
+	, radius(0)
+	, registered(false)
+	, bucket_area() {
+}
+
+AggroZones::AggroZones()
+	: cols(0)
+	, rows(0) {
+}
+
+void AggroZones::add(size_t index) {
+	AggroZone& zone = zones[index];
+
+	zone.bucket_area.x = getBucket(zone.pos.x - zone.radius, cols);
+	zone.bucket_area.y = getBucket(zone.pos.y - zone.radius, rows);
+	zone.bucket_area.w = getBucket(zone.pos.x + zone.radius, cols) - zone.bucket_area.x + 1;
+	zone.bucket_area.h = getBucket(zone.pos.y + zone.radius, rows) - zone.bucket_area.y + 1;
+
+	for (int r = zone.bucket_area.y; r < zone.bucket_area.y + zone.bucket_area.h; ++r) {
+		for (int c = zone.bucket_area.x; c < zone.bucket_area.x + zone.bucket_area.w; ++c) {
+			buckets[r * cols + c].push_back(index);
+		}
+	}
+
+	zone.registered = true;
+}
+
+void AggroZones::remove(size_t index) {
+	AggroZone& zone = zones[index];
+
+	for (int r = zone.bucket_area.y; r < zone.bucket_area.y + zone.bucket_area.h; ++r) {
+		for (int c = zone.bucket_area.x; c < zone.bucket_area.x + zone.bucket_area.w; ++c) {
+			std::vector<size_t>& bucket = buckets[r * cols + c];
+			std::vector<size_t>::iterator it = std::find(bucket.begin(), bucket.end(), index);
+			if (it != bucket.end()) {
+				*it = bucket.back();
+				bucket.pop_back();
+			}
+		}
+	}
+
+	zone.registered = false;
+}
+
+/**
+ * Move the zones of enemies that moved, and drop the zones of enemies that can't
+ * be drawn into combat by the hero anymore
+ */
+void AggroZones::update(const std::vector<Enemy*>& enemy_list, int hero_stealth, int map_w, int map_h) {
+	const int map_cols = std::max(1, (map_w + PERCEPTION_BUCKET_SIZE - 1) / PERCEPTION_BUCKET_SIZE);
+	const int map_rows = std::max(1, (map_h + PERCEPTION_BUCKET_SIZE - 1) / PERCEPTION_BUCKET_SIZE);
+
+	// the map changed size, start over
+	if (map_cols != cols || map_rows != rows) {
+		cols = map_cols;
+		rows = map_rows;
+		zones.clear();
+		buckets.clear();
+		triggered.clear();
+		triggered_zones.clear();
+		buckets.resize(cols * rows);
+	}
+
+	// the enemy list only shrinks on a new map
+	while (zones.size() > enemy_list.size()) {
+		if (zones.back().registered)
+			remove(zones.size() - 1);
+		zones.pop_back();
+	}
+	zones.resize(enemy_list.size());
+
+	for (size_t i = 0; i < enemy_list.size(); ++i) {
+		const StatBlock& stats = enemy_list[i]->stats;
+		AggroZone& zone = zones[i];
+
+		// same as the stealth threat range in BehaviorStandard::findTarget()
+		const float radius = (stats.threat_range * (100 - static_cast<float>(hero_stealth))) / 100;
+
+		// BehaviorStandard::findTarget() checks the remaining conditions for joining combat
+		const bool needed = stats.alive && !stats.hero_ally && !stats.in_combat && stats.combat_style != COMBAT_PASSIVE && radius > 0;
+
+		if (zone.registered) {
+			// most idle enemies stand still, their zones stay where they are
+			if (needed && zone.enemy == enemy_list[i] && zone.pos.x == stats.pos.x && zone.pos.y == stats.pos.y && zone.radius == radius)
+				continue;
+
+			remove(i);
+		}
+
+		zone.enemy = enemy_list[i];
+
+		if (needed) {
+			zone.pos = stats.pos;
+			zone.radius = radius;
+			add(i);
+		}
+	}
+}
+
+/**
+ * Find the zones that contain the hero
+ */
+void AggroZones::trigger(const FPoint& hero_pos) {
+	// only the zones of the last frame have to be reset
+	for (size_t i = 0; i < triggered_zones.size(); ++i) {
+		if (triggered_zones[i] < triggered.size())
+			triggered[triggered_zones[i]] = false;
+	}
+	triggered_zones.clear();
+	triggered.resize(zones.size(), false);
+
+	if (buckets.empty())
+		return;
+
+	const std::vector<size_t>& bucket = buckets[getBucket(hero_pos.y, rows) * cols + getBucket(hero_pos.x, cols)];
+	for (size_t i = 0; i < bucket.size(); ++i) {
+		const AggroZone& zone = zones[bucket[i]];
+		if (calcDist(zone.pos, hero_pos) < zone.radius) {
+			triggered[bucket[i]] = true;
+			triggered_zones.push_back(bucket[i]);
+		}
+	}
+}
+
+/**
+ * True if the zone of the enemy at this index of EnemyManager::enemies contains the hero
+ */
+bool AggroZones::isTriggered(size_t index) const {
+	return index < triggered.size() && triggered[index];
+}
+
+EnemyPerception::EnemyPerception()
+	: sight_revision(0) {
+}
+
+/**
+ * Take the positions of all possible targets for this frame
+ */
+void EnemyPerception::update(const std::vector<Enemy*>& enemy_list, int hero_stealth) {
+	allies.reset(mapr->w, mapr->h);
+	hostiles.reset(mapr->w, mapr->h);
+
+	for (size_t i = 0; i < enemy_list.size(); ++i) {
+		Enemy* e = enemy_list[i];
+		if (e->stats.hero_ally) {
+			if (!e->stats.corpse)
+				allies.insert(e);
+		}
+		else if (e->stats.in_combat) {
+			hostiles.insert(e);
+		}
+	}
+
+	aggro.update(enemy_list, hero_stealth, mapr->w, mapr->h);
+	aggro.trigger(pc->stats.pos);
+}
+
+/**
+ * The nearest hero ally that is closer than max_dist, or NULL
+ */
+Enemy* EnemyPerception::getNearestAlly(const FPoint& pos, float max_dist, float& dist) const {
+	return allies.getNearest(pos, max_dist, dist);
+}
+
+/**
+ * The nearest enemy of the hero that is in combat, or NULL
+ */
+Enemy* EnemyPerception::getNearestHostile(const FPoint& pos, float& dist) const {
+	return hostiles.getNearest(pos, std::numeric_limits<float>::max(), dist);
+}
+
+/**
+ * True if the hero is within the threat range of an enemy that is not in combat
+ */
+bool EnemyPerception::isInAggroZone(size_t index) const {
+	return aggro.isTriggered(index);
+}
+
+/**
+ * Line of sight between the tiles of two positions
+ */
+bool EnemyPerception::lineOfSight(const FPoint& from, const FPoint& to) {
+	MapCollision& collider = mapr->collider;
+
+	if (collider.revision != sight_revision) {
+		sight_lines.clear();
+		sight_revision = collider.revision;
+	}
+
+	const int x1 = static_cast<int>(from.x);
+	const int y1 = static_cast<int>(from.y);
+	const int x2 = static_cast<int>(to.x);
+	const int y2 = static_cast<int>(to.y);
+
+	if (collider.is_outside_map(x1, y1) || collider.is_outside_map(x2, y2))
+		return collider.line_of_sight(from.x, from.y, to.x, to.y);
+
+	const uint64_t key = (static_cast<uint64_t>(x1) << 48) | (static_cast<uint64_t>(y1) << 32) | (static_cast<uint64_t>(x2) << 16) | static_cast<uint64_t>(y2);
+
+	std::map<uint64_t, bool>::iterator it = sight_lines.find(key);
+	if (it != sight_lines.end())
+		return it->second;
+
+	if (sight_lines.size() >= SIGHT_CACHE_SIZE)
+		sight_lines.clear();
+
+	const bool los = collider.line_of_sight(static_cast<float>(x1) + 0.5f, static_cast<float>(y1) + 0.5f, static_cast<float>(x2) + 0.5f, static_cast<float>(y2) + 0.5f);
+	sight_lines[key] = los;
+	return los;
+}
@@ -0,0 +1,122 @@
+/*
+Copyright © 2016 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+/**
+ * class EnemyPerception
+ *
+ * What the enemy behaviors need to know about each other, gathered once per
+ * frame by EnemyManager::logic() instead of by every enemy on its own.
+ *
+ * Allies of the hero and hostile enemies in combat are sorted into a grid of
+ * buckets, so that the nearest target can be found without looking at every
+ * enemy on the map. Their positions are taken at the start of the frame.
+ *
+ * Enemies that are not in combat register their threat range as an aggro zone.
+ * Zones are kept between frames and only move when their enemy moves or the
+ * hero's stealth changes. Once per frame, the zones that contain the hero are
+ * looked up and flagged by enemy index, so idle enemies don't measure their
+ * distance to the hero.
+ *
+ * Line of sight is cached per pair of tiles and checked between the tile
+ * centers. The cache is dropped when the collision map changes.
+ */
+
+#ifndef ENEMY_PERCEPTION_H
+#define ENEMY_PERCEPTION_H
+
+#include "CommonIncludes.h"
+#include "Utils.h"
+
+#include <stdint.h>
+
+class Enemy;
+
+class PerceptionTarget {
+public:
+	Enemy* enemy;
+	FPoint pos;
+};
+
+class PerceptionGrid {
+private:
+	std::vector<PerceptionTarget> targets; // in the order of EnemyManager::enemies
+	std::vector< std::vector<size_t> > buckets;
+	int cols;
+	int rows;
+
+	int clampCol(float x) const;
+	int clampRow(float y) const;
+
+public:
+	PerceptionGrid();
+	void reset(int map_w, int map_h);
+	void insert(Enemy* enemy);
+	Enemy* getNearest(const FPoint& pos, float max_dist, float& dist) const;
+};
+
+class AggroZone {
+public:
+	Enemy* enemy;
+	FPoint pos;
+	float radius; // threat range, reduced by the hero's stealth
+	bool registered;
+	Rect bucket_area; // the buckets this zone was added to, in columns and rows
+
+	AggroZone();
+};
+
+class AggroZones {
+private:
+	std::vector<AggroZone> zones; // in the order of EnemyManager::enemies
+	std::vector< std::vector<size_t> > buckets;
+	std::vector<bool> triggered; // per zone, true if it contains the hero
+	std::vector<size_t> triggered_zones; // the zones set in triggered, so that they can be reset
+	int cols;
+	int rows;
+
+	void add(size_t index);
+	void remove(size_t index);
+
+public:
+	AggroZones();
+	void update(const std::vector<Enemy*>& enemy_list, int hero_stealth, int map_w, int map_h);
+	void trigger(const FPoint& hero_pos);
+	bool isTriggered(size_t index) const;
+};
+
+class EnemyPerception {
+private:
+	PerceptionGrid allies; // hero allies that are not corpses
+	PerceptionGrid hostiles; // enemies of the hero that are in combat
+	AggroZones aggro; // threat ranges of the enemies that are not in combat
+
+	std::map<uint64_t, bool> sight_lines;
+	unsigned sight_revision;
+
+public:
+	EnemyPerception();
+
+	void update(const std::vector<Enemy*>& enemy_list, int hero_stealth);
+
+	Enemy* getNearestAlly(const FPoint& pos, float max_dist, float& dist) const;
+	Enemy* getNearestHostile(const FPoint& pos, float& dist) const;
+	bool isInAggroZone(size_t index) const;
+
+	bool lineOfSight(const FPoint& from, const FPoint& to);
+};
+
+#endif
@@ -52,7 +52,8 @@ Entity::Entity()
 	, sound_block(0)
 	, sound_levelup(0)
 	, activeAnimation(NULL)
-	, animationSet(NULL) {
+	, animationSet(NULL)
+	, prev_pos() {
 }
 
 Entity::Entity(const Entity &e)
@@ -65,7 +66,15 @@ Entity::Entity(const Entity &e)
 	, sound_levelup(e.sound_levelup)
 	, activeAnimation(new Animation(*e.activeAnimation))
 	, animationSet(e.animationSet)
-	, stats(StatBlock(e.stats)) {
+	, stats(StatBlock(e.stats))
+	, prev_pos(e.prev_pos) {
+}
+
+/**
+ * The position to draw this entity at, between its previous and current position
+ */
+FPoint Entity::getRenderPos() const {
+	return mapr->interpolate(prev_pos, stats.pos);
 }
 
 void Entity::loadSounds(StatBlock *src_stats) {
@@ -73,22 +82,22 @@ void Entity::loadSounds(StatBlock *src_stats) {
 
 	if (!src_stats) src_stats = &stats;
 
-	for (size_t i = 0; i < src_stats->sfx_attack.size(); ++i) {
-		std::string anim_name = src_stats->sfx_attack[i].first;
-		SoundManager::SoundID sid = snd->load(src_stats->sfx_attack[i].second, "Entity attack");
+	for (size_t i = 0; i < src_stats->def->sfx_attack.size(); ++i) {
+		std::string anim_name = src_stats->def->sfx_attack[i].first;
+		SoundManager::SoundID sid = snd->load(src_stats->def->sfx_attack[i].second, "Entity attack");
 		sound_attack.push_back(std::pair<std::string, SoundManager::SoundID>(anim_name, sid));
 	}
 
-	if (src_stats->sfx_hit != "")
-		sound_hit = snd->load(src_stats->sfx_hit, "Entity was hit");
-	if (src_stats->sfx_die != "")
-		sound_die = snd->load(src_stats->sfx_die, "Entity died");
-	if (src_stats->sfx_critdie != "")
-		sound_critdie = snd->load(src_stats->sfx_critdie, "Entity died from critial hit");
-	if (src_stats->sfx_block != "")
-		sound_block = snd->load(src_stats->sfx_block, "Entity blocked");
-	if (src_stats->sfx_levelup != "")
-		sound_levelup = snd->load(src_stats->sfx_levelup, "Entity leveled up");
+	if (src_stats->def->sfx_hit != "")
+		sound_hit = snd->load(src_stats->def->sfx_hit, "Entity was hit");
+	if (src_stats->def->sfx_die != "")
+		sound_die = snd->load(src_stats->def->sfx_die, "Entity died");
+	if (src_stats->def->sfx_critdie != "")
+		sound_critdie = snd->load(src_stats->def->sfx_critdie, "Entity died from critial hit");
+	if (src_stats->def->sfx_block != "")
+		sound_block = snd->load(src_stats->def->sfx_block, "Entity blocked");
+	if (src_stats->def->sfx_levelup != "")
+		sound_levelup = snd->load(src_stats->def->sfx_levelup, "Entity leveled up");
 }
 
 void Entity::unloadSounds() {
@@ -195,8 +204,8 @@ bool Entity::takeHit(Hazard &h) {
 	if(!powers->powers[h.power_index].target_categories.empty() && !stats.hero) {
 		//the power has a target category requirement, so if it doesnt match, dont continue
 		bool match_found = false;
-		for (unsigned int i=0; i<stats.categories.size(); i++) {
-			if(std::find(powers->powers[h.power_index].target_categories.begin(), powers->powers[h.power_index].target_categories.end(), stats.categories[i]) != powers->powers[h.power_index].target_categories.end()) {
+		for (unsigned int i=0; i<stats.def->categories.size(); i++) {
+			if(std::find(powers->powers[h.power_index].target_categories.begin(), powers->powers[h.power_index].target_categories.end(), stats.def->categories[i]) != powers->powers[h.power_index].target_categories.end()) {
 				match_found = true;
 			}
 		}
@@ -66,6 +66,9 @@ public:
 	AnimationSet *animationSet;
 
 	StatBlock stats;
+
+	FPoint prev_pos; // stats.pos at the start of the current logic frame
+	FPoint getRenderPos() const;
 };
 
 extern const int directionDeltaX[];
@@ -0,0 +1,204 @@
+/*
+Copyright © 2016 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+#include "EventIndex.h"
+#include "EventManager.h"
+#include "Settings.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+
+// width and height of a bucket, in tiles
+const int EVENT_BUCKET_SIZE = 8;
+
+EventBucketGrid::EventBucketGrid()
+	: cols(0)
+	, rows(0) {
+}
+
+int EventBucketGrid::clampCol(int x) const {
+	int col = (x < 0 ? 0 : x / EVENT_BUCKET_SIZE);
+	return std::min(col, cols-1);
+}
+
+int EventBucketGrid::clampRow(int y) const {
+	int row = (y < 0 ? 0 : y / EVENT_BUCKET_SIZE);
+	return std::min(row, rows-1);
+}
+
+void EventBucketGrid::reset(int map_w, int map_h) {
+	cols = std::max(1, (map_w + EVENT_BUCKET_SIZE - 1) / EVENT_BUCKET_SIZE);
+	rows = std::max(1, (map_h + EVENT_BUCKET_SIZE - 1) / EVENT_BUCKET_SIZE);
+
+	buckets.clear();
+	buckets.resize(cols * rows);
+}
+
+/**
+ * Add an event to every bucket its area overlaps
+ * Areas outside of the map are clamped to the buckets at the map edge
+ */
+void EventBucketGrid::insert(const Rect& area, size_t event_index) {
+	if (buckets.empty() || area.w <= 0 || area.h <= 0)
+		return;
+
+	int col_start = clampCol(area.x);
+	int col_end = clampCol(area.x + area.w - 1);
+	int row_start = clampRow(area.y);
+	int row_end = clampRow(area.y + area.h - 1);
+
+	for (int row = row_start; row <= row_end; ++row) {
+		for (int col = col_start; col <= col_end; ++col) {
+			buckets[row * cols + col].push_back(event_index);
+		}
+	}
+}
+
+/**
+ * Append the events of all buckets overlapping area to out
+ * The result may contain duplicates
+ */
+void EventBucketGrid::query(const Rect& area, std::vector<size_t>& out) const {
+	if (buckets.empty())
+		return;
+
+	int col_start = clampCol(area.x);
+	int col_end = clampCol(area.x + std::max(area.w, 1) - 1);
+	int row_start = clampRow(area.y);
+	int row_end = clampRow(area.y + std::max(area.h, 1) - 1);
+
+	for (int row = row_start; row <= row_end; ++row) {
+		for (int col = col_start; col <= col_end; ++col) {
+			const std::vector<size_t>& bucket = buckets[row * cols + col];
+			out.insert(out.end(), bucket.begin(), bucket.end());
+		}
+	}
+}
+
+EventIndex::EventIndex()
+	: event_count(0)
+	, dirty(true) {
+}
+
+void EventIndex::invalidate() {
+	dirty = true;
+}
+
+bool EventIndex::needsUpdate(const std::vector<Event>& events) const {
+	return dirty || events.size() != event_count;
+}
+
+/**
+ * Rebuild the index for the current list of events
+ * tile_margin is the distance (in tiles) a map tile's graphics can reach from the tile itself
+ */
+void EventIndex::build(std::vector<Event>& events, int map_w, int map_h, int tile_margin) {
+	location_grid.reset(map_w, map_h);
+	hotspot_grid.reset(map_w, map_h);
+	center_grid.reset(map_w, map_h);
+	always.clear();
+
+	const float units_per_pixel = std::max(UNITS_PER_PIXEL_X, UNITS_PER_PIXEL_Y);
+
+	for (size_t i = 0; i < events.size(); ++i) {
+		Event& ev = events[i];
+
+		if (ev.activate_type == EVENT_STATIC || ev.activate_type == EVENT_ON_CLEAR || ev.activate_type == EVENT_ON_LEAVE) {
+			always.push_back(i);
+		}
+		else {
+			location_grid.insert(ev.location, i);
+		}
+
+		if (ev.hotspot.w > 0 && ev.hotspot.h > 0) {
+			Event_Component* npc = ev.getComponent(EC_NPC_HOTSPOT);
+			if (npc) {
+				// the clickable area is the npc sprite, which is given in pixels relative to the npc position
+				int pixels = std::max(std::max(abs(npc->z), abs(npc->b - npc->z)), std::max(abs(npc->a), abs(npc->c - npc->a)));
+				int margin = static_cast<int>(ceilf(static_cast<float>(pixels) * units_per_pixel)) + 1;
+				Rect area;
+				area.x = npc->x - margin;
+				area.y = npc->y - margin;
+				area.w = area.h = margin * 2 + 1;
+				hotspot_grid.insert(area, i);
+			}
+			else {
+				Rect area = ev.hotspot;
+				area.x -= tile_margin;
+				area.y -= tile_margin;
+				area.w += tile_margin * 2;
+				area.h += tile_margin * 2;
+				hotspot_grid.insert(area, i);
+			}
+		}
+
+		if (ev.hotspot.h != 0) {
+			Rect area;
+			area.x = static_cast<int>(floorf(ev.center.x));
+			area.y = static_cast<int>(floorf(ev.center.y));
+			area.w = area.h = 1;
+			center_grid.insert(area, i);
+		}
+	}
+
+	event_count = events.size();
+	dirty = false;
+}
+
+void EventIndex::sortDescending(std::vector<size_t>& v) {
+	std::sort(v.begin(), v.end(), std::greater<size_t>());
+	v.erase(std::unique(v.begin(), v.end()), v.end());
+}
+
+void EventIndex::getLocationEvents(const Point& tile, std::vector<size_t>& out) const {
+	out.clear();
+
+	Rect area;
+	area.x = tile.x;
+	area.y = tile.y;
+	area.w = area.h = 1;
+	location_grid.query(area, out);
+
+	out.insert(out.end(), always.begin(), always.end());
+	sortDescending(out);
+}
+
+void EventIndex::getHotspotEvents(const Point& tile, std::vector<size_t>& out) const {
+	out.clear();
+
+	Rect area;
+	area.x = tile.x;
+	area.y = tile.y;
+	area.w = area.h = 1;
+	hotspot_grid.query(area, out);
+
+	sortDescending(out);
+}
+
+void EventIndex::getEventsInRange(const FPoint& pos, float range, std::vector<size_t>& out) const {
+	out.clear();
+
+	Rect area;
+	area.x = static_cast<int>(floorf(pos.x - range));
+	area.y = static_cast<int>(floorf(pos.y - range));
+	area.w = static_cast<int>(ceilf(pos.x + range)) - area.x + 1;
+	area.h = static_cast<int>(ceilf(pos.y + range)) - area.y + 1;
+	center_grid.query(area, out);
+
+	sortDescending(out);
+}
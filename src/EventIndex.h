@@ -0,0 +1,79 @@
+/*
+Copyright © 2016 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+/**
+ * class EventIndex
+ *
+ * Tile-bucketed lookup of map events, so that the per-frame event checks in
+ * MapRenderer only look at the events near the hero and the mouse cursor.
+ *
+ * Events are referenced by their index in Map::events. Any change to that
+ * list (load, erase, push_back) invalidates the index, which is then rebuilt
+ * the next time it is queried.
+ */
+
+#ifndef EVENT_INDEX_H
+#define EVENT_INDEX_H
+
+#include "CommonIncludes.h"
+#include "Utils.h"
+
+class Event;
+
+class EventBucketGrid {
+private:
+	std::vector< std::vector<size_t> > buckets;
+	int cols;
+	int rows;
+
+	int clampCol(int x) const;
+	int clampRow(int y) const;
+
+public:
+	EventBucketGrid();
+	void reset(int map_w, int map_h);
+	void insert(const Rect& area, size_t event_index);
+	void query(const Rect& area, std::vector<size_t>& out) const;
+};
+
+class EventIndex {
+private:
+	EventBucketGrid location_grid; // events triggered by standing inside their location
+	EventBucketGrid hotspot_grid; // events that can be clicked, padded by the size of their graphics
+	EventBucketGrid center_grid; // events that can be activated from a distance
+	std::vector<size_t> always; // events that have to be checked regardless of position
+
+	size_t event_count;
+	bool dirty;
+
+	static void sortDescending(std::vector<size_t>& v);
+
+public:
+	EventIndex();
+
+	void invalidate();
+	bool needsUpdate(const std::vector<Event>& events) const;
+	void build(std::vector<Event>& events, int map_w, int map_h, int tile_margin);
+
+	// All of these return event indices sorted in descending order,
+	// which matches the order the event checks iterate (and erase) events in
+	void getLocationEvents(const Point& tile, std::vector<size_t>& out) const;
+	void getHotspotEvents(const Point& tile, std::vector<size_t>& out) const;
+	void getEventsInRange(const FPoint& pos, float range, std::vector<size_t>& out) const;
+};
+
+#endif
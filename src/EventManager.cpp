@@ -37,7 +37,11 @@ Event::Event()
 	, cooldown_ticks(0)
 	, keep_after_trigger(true)
 	, center(FPoint(-1, -1))
-	, reachable_from(Rect()) {
+	, reachable_from(Rect())
+	, light()
+	, conditions_compiled(false)
+	, active_state(0)
+	, is_active(false) {
 }
 
 Event::~Event() {
@@ -149,6 +153,11 @@ void EventManager::loadEvent(FileParser &infile, Event* evnt) {
 		evnt->reachable_from.w = popFirstInt(infile.val);
 		evnt->reachable_from.h = popFirstInt(infile.val);
 	}
+	else if (infile.key == "light") {
+		// @ATTR event.light|float, color|Radius (in map units) and color of a light at the center of the event. Only shown on maps with "ambient_light".
+		evnt->light.radius = toFloat(popFirstString(infile.val));
+		evnt->light.color = toRGB(infile.val);
+	}
 	else {
 		loadEventComponent(infile, evnt, NULL);
 	}
@@ -664,8 +673,8 @@ bool EventManager::executeEvent(Event &ev) {
 		else if (ec->type == EC_MAPMOD) {
 			if (ec->s == "collision") {
 				if (ec->x >= 0 && ec->x < mapr->w && ec->y >= 0 && ec->y < mapr->h) {
-					mapr->collider.colmap[ec->x][ec->y] = static_cast<unsigned short>(ec->z);
-					mapr->map_change = true;
+					mapr->collider.set_tile(ec->x, ec->y, static_cast<unsigned short>(ec->z));
+					mapr->map_changes.push_back(Point(ec->x, ec->y));
 				}
 				else
 					logError("EventManager: Mapmod at position (%d, %d) is out of bounds 0-255.", ec->x, ec->y);
@@ -820,12 +829,55 @@ bool EventManager::executeEvent(Event &ev) {
 }
 
 
-bool EventManager::isActive(const Event &e) {
+/**
+ * Convert the requirement components of an event to a list of conditions that
+ * can be checked without any string comparisons
+ */
+void EventManager::compileConditions(Event &e) {
+	e.conditions.clear();
+
 	for (size_t i=0; i < e.components.size(); i++) {
-		if (!camp->checkAllRequirements(e.components[i]))
-			return false;
+		const Event_Component& ec = e.components[i];
+		EventCondition cond;
+		cond.type = ec.type;
+
+		if (ec.type == EC_REQUIRES_STATUS || ec.type == EC_REQUIRES_NOT_STATUS) {
+			// empty statuses are never set
+			cond.id = ec.s.empty() ? -1 : camp->getStatusID(ec.s);
+		}
+		else if (ec.type == EC_REQUIRES_CURRENCY || ec.type == EC_REQUIRES_NOT_CURRENCY ||
+		         ec.type == EC_REQUIRES_ITEM || ec.type == EC_REQUIRES_NOT_ITEM ||
+		         ec.type == EC_REQUIRES_LEVEL || ec.type == EC_REQUIRES_NOT_LEVEL) {
+			cond.id = ec.x;
+		}
+		else if (ec.type == EC_REQUIRES_CLASS || ec.type == EC_REQUIRES_NOT_CLASS) {
+			cond.s = ec.s;
+		}
+		else {
+			// not a requirement
+			continue;
+		}
+
+		e.conditions.push_back(cond);
 	}
-	return true;
+
+	e.conditions_compiled = true;
+	e.active_state = 0;
+}
+
+/**
+ * The result is cached until the campaign state, inventory or hero level changes
+ */
+bool EventManager::isActive(Event &e) {
+	if (!e.conditions_compiled)
+		compileConditions(e);
+
+	if (e.active_state == 0 || e.active_state != camp->state_version) {
+		e.is_active = camp->checkAllConditions(e.conditions);
+		e.active_state = camp->state_version;
+	}
+
+	return e.is_active;
 }
 
 void EventManager::executeScript(const std::string& filename, float x, float y) {
@@ -47,6 +47,12 @@ public:
 	bool keep_after_trigger; // if this event has been triggered once, should this event be kept? If so, this event can be triggered multiple times.
 	FPoint center;
 	Rect reachable_from;
+	LightSource light;
+
+	std::vector<EventCondition> conditions; // the requires_* components, compiled on load
+	bool conditions_compiled;
+	unsigned active_state; // the CampaignManager::state_version that is_active was calculated for
+	bool is_active;
 
 	Event();
 	~Event();
@@ -64,7 +70,8 @@ public:
 	static bool loadEventComponentString(std::string &key, std::string &val, Event* evnt, Event_Component* ec);
 
 	static bool executeEvent(Event &e);
-	static bool isActive(const Event &e);
+	static void compileConditions(Event &e);
+	static bool isActive(Event &e);
 	static void executeScript(const std::string& filename, float x, float y);
 
 private:
@@ -16,6 +16,7 @@ You should have received a copy of the GNU General Public License along with
 FLARE.  If not, see http://www.gnu.org/licenses/
 */
 
+#include "DataCache.h"
 #include "FileParser.h"
 #include "UtilsParsing.h"
 #include "UtilsFileSystem.h"
@@ -28,6 +29,10 @@ FileParser::FileParser()
 	, line("")
 	, line_number(0)
 	, include_fp(NULL)
+	, cache_entry(NULL)
+	, cache_index(0)
+	, cache_record(NULL)
+	, cache_name("")
 	, new_section(false)
 	, section("")
 	, key("")
@@ -95,7 +100,46 @@ bool FileParser::open(const std::string& _filename, bool locateFileName, const s
 	return ret;
 }
 
+bool FileParser::openCached(const std::string& _filename, const std::string &_errormessage) {
+	close();
+
+	if (!data_cache)
+		return open(_filename, true, _errormessage);
+
+	std::vector<std::string> sources = mods->list(_filename);
+	DataCacheEntry* entry = data_cache->get(_filename, sources);
+
+	if (entry) {
+		filenames = sources;
+		current_index = 0;
+		line_number = 0;
+		this->errormessage = _errormessage;
+		cache_entry = entry;
+		cache_index = 0;
+		return true;
+	}
+
+	if (!open(_filename, true, _errormessage))
+		return false;
+
+	cache_name = _filename;
+	cache_record = new DataCacheEntry();
+	cache_record->sources = sources;
+	for (size_t i = 0; i < sources.size(); ++i) {
+		cache_record->addFile(sources[i]);
+	}
+
+	return true;
+}
+
 void FileParser::close() {
+	cache_entry = NULL;
+	cache_index = 0;
+
+	// an incomplete stream is never stored in the cache
+	delete cache_record;
+	cache_record = NULL;
+
 	if (include_fp) {
 		include_fp->close();
 		delete include_fp;
@@ -114,6 +158,53 @@ void FileParser::close() {
  * @return false if EOF, otherwise true
  */
 bool FileParser::next() {
+	if (cache_entry) {
+		if (cache_index >= cache_entry->lines.size())
+			return false;
+
+		const DataCacheLine& cache_line = cache_entry->lines[cache_index++];
+		new_section = cache_line.new_section;
+		section = cache_line.section;
+		key = cache_line.key;
+		val = cache_line.val;
+		return true;
+	}
+
+	bool ret = nextFromFile();
+
+	if (cache_record) {
+		if (ret) {
+			FileParser* active = getActiveParser();
+
+			DataCacheLine cache_line;
+			cache_line.new_section = new_section;
+			cache_line.file = cache_record->addFile(active->filenames[active->current_index]);
+			cache_line.line_number = active->line_number;
+			cache_line.section = section;
+			cache_line.key = key;
+			cache_line.val = val;
+			cache_record->lines.push_back(cache_line);
+		}
+		else {
+			data_cache->store(cache_name, *cache_record);
+			delete cache_record;
+			cache_record = NULL;
+		}
+	}
+
+	return ret;
+}
+
+/**
+ * Returns the innermost parser that is currently reading, following INCLUDE directives
+ */
+FileParser* FileParser::getActiveParser() {
+	if (include_fp)
+		return include_fp->getActiveParser();
+	return this;
+}
+
+bool FileParser::nextFromFile() {
 
 	std::string starts_with;
 	new_section = false;
@@ -229,7 +320,13 @@ void FileParser::error(const char* format, ...) {
 }
 
 void FileParser::errorBuf(const char* buffer) {
-	if (include_fp) {
+	if (cache_entry && !cache_entry->lines.empty()) {
+		const DataCacheLine& cache_line = cache_entry->lines[cache_index > 0 ? cache_index-1 : 0];
+		std::stringstream ss;
+		ss << "[" << cache_entry->files[cache_line.file].path << ":" << cache_line.line_number << "] " << buffer;
+		logError(ss.str().c_str());
+	}
+	else if (include_fp) {
 		include_fp->errorBuf(buffer);
 	}
 	else {
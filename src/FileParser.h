@@ -27,9 +27,13 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 
 #include "CommonIncludes.h"
 
+class DataCacheEntry;
+
 class FileParser {
 private:
 	void errorBuf(const char* buffer);
+	bool nextFromFile();
+	FileParser* getActiveParser();
 
 	std::vector<std::string> filenames;
 	unsigned current_index;
@@ -42,6 +46,14 @@ private:
 
 	FileParser* include_fp;
 
+	// replaying a stream from the DataCache
+	DataCacheEntry* cache_entry;
+	size_t cache_index;
+
+	// recording a stream for the DataCache
+	DataCacheEntry* cache_record;
+	std::string cache_name;
+
 public:
 	FileParser();
 	~FileParser();
@@ -68,6 +80,16 @@ public:
 	 */
 	bool open(const std::string& filename, bool locateFileName = true, const std::string &errormessage = "Could not open text file");
 
+	/**
+	 * @brief openCached
+	 * Same as open() for generic (mod-located) filenames, but the resulting
+	 * key/value stream is taken from the DataCache when it is up to date. If it
+	 * isn't, the files are parsed as usual and the stream is stored in the cache
+	 * once the end of the data is reached.
+	 * getRawLine() is not available for cached files.
+	 */
+	bool openCached(const std::string& filename, const std::string &errormessage = "Could not open text file");
+
 	void close();
 	bool next();
 	std::string getRawLine();
@@ -26,6 +26,7 @@ GameState::GameState()
 	, reload_backgrounds(false)
 	, save_settings_on_exit(true)
 	, load_counter(0)
+	, interpolation(1)
 	, requestedGameState(NULL)
 	, exitRequested(false)
 	, loading_tip(new WidgetTooltip())
@@ -50,6 +50,9 @@ public:
 
 	int load_counter;
 
+	// how far rendering is between the previous and the current logic frame, from 0 to 1
+	float interpolation;
+
 protected:
 	GameState* requestedGameState;
 	bool exitRequested;
@@ -70,9 +70,17 @@ GameStatePlay::GameStatePlay()
 	, npc_from_map(true)
 	, nearest_npc(-1)
 	, menu_enemy_timeout(MAX_FRAMES_PER_SEC*10)
+	, rens()
+	, rens_dead()
+	, lights()
 {
 	hasMusic = true;
 	has_background = false;
+
+	// enough for a busy screen; the queues grow if needed and keep their capacity
+	rens.reserve(RENDER_QUEUE_RESERVE);
+	rens_dead.reserve(RENDER_QUEUE_RESERVE);
+	lights.reserve(RENDER_QUEUE_RESERVE);
 	// GameEngine scope variables
 
 	if (items == NULL)
@@ -109,7 +117,7 @@ void GameStatePlay::refreshWidgets() {
 void GameStatePlay::resetGame() {
 	mapr->load("maps/spawn.txt");
 	setLoadingFrame();
-	camp->status.clear();
+	camp->clearStatus();
 	pc->init();
 	pc->stats.currency = 0;
 	menu->act->clear();
@@ -120,6 +128,7 @@ void GameStatePlay::resetGame() {
 	menu->questlog->clear();
 	quests->createQuestList();
 	menu->hudlog->clear();
+	menu->mini->clearExplored();
 	save_load->loadStash();
 
 	// Finalize new character settings
@@ -163,7 +172,7 @@ void GameStatePlay::checkEnemyFocus() {
 			hazards->last_enemy = NULL;
 		}
 		else {
-			enemy = enemies->enemyFocus(inpt->mouse, mapr->cam, true);
+			enemy = enemies->enemyFocus(inpt->mouse, true);
 			if (enemy) curs->setCursor(CURSOR_ATTACK);
 			src_pos = screen_to_map(inpt->mouse.x, inpt->mouse.y, mapr->cam.x, mapr->cam.y);
 
@@ -179,7 +188,7 @@ void GameStatePlay::checkEnemyFocus() {
 	}
 	else if (inpt->usingMouse()) {
 		// if we're using a mouse and we didn't select an enemy, try selecting a dead one instead
-		Enemy *temp_enemy = enemies->enemyFocus(inpt->mouse, mapr->cam, false);
+		Enemy *temp_enemy = enemies->enemyFocus(inpt->mouse, false);
 		if (temp_enemy) {
 			pc->stats.target_corpse = &(temp_enemy->stats);
 			menu->enemy->enemy = temp_enemy;
@@ -249,7 +258,7 @@ void GameStatePlay::checkLoot() {
 
 	// Normal pickups
 	if (!pc->stats.attacking) {
-		pickup = loot->checkPickup(inpt->mouse, mapr->cam, pc->stats.pos);
+		pickup = loot->checkPickup(inpt->mouse, pc->stats.pos);
 	}
 
 	if (!pickup.empty()) {
@@ -288,6 +297,7 @@ void GameStatePlay::checkTeleport() {
 					mapr->collider.block(enemies->enemies[i]->stats.pos.x, enemies->enemies[i]->stats.pos.y, true);
 				}
 			}
+			enemies->syncComponents();
 		}
 
 		// process intermap teleport
@@ -297,6 +307,11 @@ void GameStatePlay::checkTeleport() {
 			inpt->lock_all = (teleport_mapname == "maps/spawn.txt");
 			mapr->executeOnMapExitEvents();
 			showLoading();
+
+			uint64_t load_ticks = SDL_GetPerformanceCounter();
+			unsigned image_hits = image_cache->hits;
+			unsigned image_misses = image_cache->misses;
+
 			mapr->load(teleport_mapname);
 			setLoadingFrame();
 			enemies->handleNewMap();
@@ -307,9 +322,17 @@ void GameStatePlay::checkTeleport() {
 			npcs->handleNewMap();
 			resetNPC();
 			menu->stash->visible = false;
-			menu->mini->prerender(&mapr->collider, mapr->w, mapr->h);
+			menu->mini->prerender(&mapr->collider, mapr->w, mapr->h, mapr->getFilename());
 			npc_id = nearest_npc = -1;
 
+			double load_ms = static_cast<double>(SDL_GetPerformanceCounter() - load_ticks) * 1000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+			logInfo("GameStatePlay: Loaded %s in %.0f ms. Image cache: %u hits, %u misses.", teleport_mapname.c_str(), load_ms, image_cache->hits - image_hits, image_cache->misses - image_misses);
+
+			const TextureMemory& texture_memory = render_device->getTextureMemory();
+			if (texture_memory.full_bytes > 0) {
+				logInfo("GameStatePlay: Textures after loading %s: %lu KiB (%lu KiB as 32-bit images at full size)", teleport_mapname.c_str(), texture_memory.bytes / 1024, texture_memory.full_bytes / 1024);
+			}
+
 			// use the default hero spawn position for this map
 			if (mapr->teleport_destination.x == -1 && mapr->teleport_destination.y == -1) {
 				mapr->cam.x = pc->stats.pos.x = mapr->hero_pos.x;
@@ -799,6 +822,13 @@ void GameStatePlay::updateActionBar(unsigned index) {
  * This includes some message passing between child object
  */
 void GameStatePlay::logic() {
+	// rendering is interpolated from the positions at the start of this frame
+	mapr->prev_cam = mapr->cam;
+	pc->prev_pos = pc->stats.pos;
+	for (size_t i = 0; i < enemies->enemies.size(); ++i) {
+		enemies->enemies[i]->prev_pos = enemies->enemies[i]->stats.pos;
+	}
+
 	if (inpt->window_resized)
 		refreshWidgets();
 
@@ -812,6 +842,10 @@ void GameStatePlay::logic() {
 		// these actions only occur when the game isn't paused
 		if (pc->stats.alive) checkLoot();
 		checkEnemyFocus();
+
+		// once per frame, before the first map event is checked
+		camp->checkStateChange();
+
 		if (pc->stats.alive) {
 			mapr->checkHotspots();
 			mapr->checkNearestEvent();
@@ -961,10 +995,16 @@ void GameStatePlay::logic() {
  */
 void GameStatePlay::render() {
 
+	// draw the hero, enemies and camera between their previous and current logic positions
+	// the logic camera is restored afterwards, as it is used by the game logic
+	mapr->interpolation = interpolation;
+	const FPoint logic_cam = mapr->cam;
+	mapr->cam = mapr->interpolate(mapr->prev_cam, mapr->cam);
+
 	// Create a list of Renderables from all objects not already on the map.
 	// split the list into the beings alive (may move) and dead beings (must not move)
-	std::vector<Renderable> rens;
-	std::vector<Renderable> rens_dead;
+	rens.clear();
+	rens_dead.clear();
 
 	pc->addRenders(rens);
 
@@ -976,16 +1016,18 @@ void GameStatePlay::render() {
 
 	hazards->addRenders(rens, rens_dead);
 
+	lights.clear();
+	hazards->addLights(lights);
 
 	// render the static map layers plus the renderables
-	mapr->render(rens, rens_dead);
+	mapr->render(rens, rens_dead, lights);
 
 	// mouseover tooltips
 	loot->renderTooltips(mapr->cam);
 
-	if (mapr->map_change) {
-		menu->mini->prerender(&mapr->collider, mapr->w, mapr->h);
-		mapr->map_change = false;
+	if (!mapr->map_changes.empty()) {
+		menu->mini->update(mapr->map_changes);
+		mapr->map_changes.clear();
 	}
 	menu->mini->setMapTitle(mapr->title);
 	menu->mini->render(pc->stats.pos);
@@ -995,6 +1037,8 @@ void GameStatePlay::render() {
 	// attacked, even if you have menus open
 	if (!isPaused())
 		comb->render();
+
+	mapr->cam = logic_cam;
 }
 
 bool GameStatePlay::isPaused() {
@@ -42,6 +42,9 @@ class WidgetLabel;
 
 class ActionData;
 
+// initial capacity of the per-frame render queues
+const size_t RENDER_QUEUE_RESERVE = 256;
+
 class Title {
 public:
 	std::string title;
@@ -103,6 +106,11 @@ private:
 
 	int menu_enemy_timeout;
 
+	// filled again each frame; cleared without freeing, so rendering doesn't allocate
+	std::vector<Renderable> rens;
+	std::vector<Renderable> rens_dead;
+	std::vector<LightSource> lights;
+
 public:
 	GameStatePlay();
 	~GameStatePlay();
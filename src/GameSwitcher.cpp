@@ -266,12 +266,16 @@ bool GameSwitcher::isPaused() {
 	return currentState->isPaused();
 }
 
-void GameSwitcher::render() {
+/**
+ * interpolation is how far the current time is between the previous and the next logic frame
+ */
+void GameSwitcher::render(float interpolation) {
 	// display background
 	if (background && currentState->has_background) {
 		render_device->render(background);
 	}
 
+	currentState->interpolation = interpolation;
 	currentState->render();
 	curs->render();
 }
@@ -75,7 +75,7 @@ public:
 	bool isLoadingFrame();
 	bool isPaused();
 	void logic();
-	void render();
+	void render(float interpolation);
 	void showFPS(int fps);
 	void saveUserSettings();
 	bool done;
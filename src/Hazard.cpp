@@ -28,6 +28,8 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include "AnimationManager.h"
 #include "Hazard.h"
 #include "MapCollision.h"
+#include "MapRenderer.h"
+#include "SharedGameResources.h"
 #include "SharedResources.h"
 #include "StatBlock.h"
 #include "Settings.h"
@@ -48,6 +50,7 @@ Hazard::Hazard(MapCollision *_collider)
 	, source_type(0)
 	, target_party(false)
 	, pos()
+	, prev_pos()
 	, speed()
 	, pos_offset()
 	, relative_pos(false)
@@ -59,6 +62,7 @@ Hazard::Hazard(MapCollision *_collider)
 	, power_index(0)
 	, animationKind(0)
 	, on_floor(false)
+	, light()
 	, delay_frames(0)
 	, complete_animation(false)
 	, multitarget(false)
@@ -125,6 +129,9 @@ Hazard::~Hazard() {
 
 void Hazard::logic() {
 
+	// rendering is interpolated from the position at the start of this frame
+	prev_pos = pos;
+
 	// if the hazard is on delay, take no action
 	if (delay_frames > 0) {
 		delay_frames--;
@@ -242,14 +249,29 @@ void Hazard::addEntity(Entity *ent) {
 
 void Hazard::addRenderable(std::vector<Renderable> &r, std::vector<Renderable> &r_dead) {
 	if (delay_frames == 0 && activeAnimation) {
-		Renderable re = activeAnimation->getCurrentFrame(animationKind);
-		re.map_pos.x = pos.x;
-		re.map_pos.y = pos.y;
+		std::vector<Renderable>& queue = (on_floor ? r_dead : r);
+		queue.resize(queue.size()+1);
+		Renderable& re = queue.back();
+		activeAnimation->getCurrentFrame(animationKind, re);
+		re.map_pos = getRenderPos();
 		re.prio = (on_floor ? 0 : 2);
-		(on_floor ? r_dead : r).push_back(re);
 	}
 }
 
+void Hazard::addLight(std::vector<LightSource> &lights) {
+	if (delay_frames == 0 && light.radius > 0) {
+		lights.push_back(light);
+		lights.back().pos = getRenderPos();
+	}
+}
+
+/**
+ * The position to draw this hazard at, between its previous and current position
+ */
+FPoint Hazard::getRenderPos() const {
+	return mapr->interpolate(prev_pos, pos);
+}
+
 void Hazard::setAngle(const float& _angle) {
 	angle = _angle;
 	while (angle >= static_cast<float>(M_PI)*2) angle -= static_cast<float>(M_PI)*2;
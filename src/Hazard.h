@@ -83,6 +83,7 @@ public:
 	bool target_party;
 
 	FPoint pos;
+	FPoint prev_pos; // pos at the start of the current logic frame
 	FPoint speed;
 	FPoint pos_offset;
 	bool relative_pos;
@@ -98,9 +99,12 @@ public:
 	// some hazard animations have random/varietal options
 
 	bool isDangerousNow();
+	FPoint getRenderPos() const;
 	void addRenderable(std::vector<Renderable> &r, std::vector<Renderable> &r_dead);
+	void addLight(std::vector<LightSource> &lights);
 
 	bool on_floor; // rendererable goes on the floor layer
+	LightSource light;
 	int delay_frames;
 	bool complete_animation; // if not multitarget but hitting a creature, still complete the animation?
 
@@ -39,11 +39,14 @@ HazardManager::HazardManager()
 	Color mark_color(255, 0, 0, 255);
 
 	int marker_size = TILE_H_HALF+1;
-	dev_marker.image = render_device->createImage(marker_size, marker_size);
+	std::vector<Color> marker_pixels(marker_size * marker_size, Color(0,0,0,0));
 	for (int i = 0; i < marker_size; ++i) {
-		dev_marker.image->drawPixel(i, (marker_size-1)/2, mark_color);
-		dev_marker.image->drawPixel((marker_size-1)/2, i, mark_color);
+		marker_pixels[((marker_size-1)/2) * marker_size + i] = mark_color;
+		marker_pixels[i * marker_size + (marker_size-1)/2] = mark_color;
 	}
+	dev_marker.image = render_device->createImage(marker_size, marker_size);
+	if (dev_marker.image)
+		dev_marker.image->writePixels(Rect(0, 0, marker_size, marker_size), marker_pixels);
 	dev_marker.src.x = 0;
 	dev_marker.src.y = 0;
 	dev_marker.src.w = marker_size;
@@ -98,6 +101,9 @@ void HazardManager::logic() {
 
 	bool hit;
 
+	// positions and hp of the enemies, read from the component arrays
+	const EnemyComponents& components = enemies->components;
+
 	// handle collisions
 	for (size_t i=0; i<h.size(); i++) {
 		if (h[i]->isDangerousNow()) {
@@ -107,13 +113,14 @@ void HazardManager::logic() {
 				for (unsigned int eindex = 0; eindex < enemies->enemies.size(); eindex++) {
 
 					// only check living enemies
-					if (enemies->enemies[eindex]->stats.hp > 0 && h[i]->active && (enemies->enemies[eindex]->stats.hero_ally == h[i]->target_party)) {
-						if (isWithinRadius(h[i]->pos, h[i]->radius, enemies->enemies[eindex]->stats.pos)) {
+					if (components.hp[eindex] > 0 && h[i]->active && (components.hero_ally[eindex] == h[i]->target_party)) {
+						if (isWithinRadius(h[i]->pos, h[i]->radius, components.pos[eindex])) {
 							if (!h[i]->hasEntity(enemies->enemies[eindex])) {
 								h[i]->addEntity(enemies->enemies[eindex]);
 								if (!h[i]->beacon) last_enemy = enemies->enemies[eindex];
 								// hit!
 								hit = enemies->enemies[eindex]->takeHit(*h[i]);
+								enemies->syncComponents(eindex);
 								hitEntity(i, hit);
 							}
 						}
@@ -138,12 +145,13 @@ void HazardManager::logic() {
 				//now process allies
 				for (unsigned int eindex = 0; eindex < enemies->enemies.size(); eindex++) {
 					// only check living allies
-					if (enemies->enemies[eindex]->stats.hp > 0 && h[i]->active && enemies->enemies[eindex]->stats.hero_ally) {
-						if (isWithinRadius(h[i]->pos, h[i]->radius, enemies->enemies[eindex]->stats.pos)) {
+					if (components.hp[eindex] > 0 && h[i]->active && components.hero_ally[eindex]) {
+						if (isWithinRadius(h[i]->pos, h[i]->radius, components.pos[eindex])) {
 							if (!h[i]->hasEntity(enemies->enemies[eindex])) {
 								h[i]->addEntity(enemies->enemies[eindex]);
 								// hit!
 								hit = enemies->enemies[eindex]->takeHit(*h[i]);
+								enemies->syncComponents(eindex);
 								hitEntity(i, hit);
 							}
 						}
@@ -183,11 +191,14 @@ void HazardManager::checkNewHazards() {
 		Hazard *new_haz = powers->hazards.front();
 		powers->hazards.pop();
 
+		// new hazards are drawn where they appear, not moving in from the map origin
+		new_haz->prev_pos = new_haz->pos;
 		h.push_back(new_haz);
 	}
 
 	// check hero hazards
 	if (pc->haz != NULL) {
+		pc->haz->prev_pos = pc->haz->pos;
 		h.push_back(pc->haz);
 		pc->haz = NULL;
 	}
@@ -195,6 +206,7 @@ void HazardManager::checkNewHazards() {
 	// check monster hazards
 	for (unsigned int eindex = 0; eindex < enemies->enemies.size(); eindex++) {
 		if (enemies->enemies[eindex]->haz != NULL) {
+			enemies->enemies[eindex]->haz->prev_pos = enemies->enemies[eindex]->haz->pos;
 			h.push_back(enemies->enemies[eindex]->haz);
 			enemies->enemies[eindex]->haz = NULL;
 		}
@@ -229,6 +241,16 @@ void HazardManager::addRenders(std::vector<Renderable> &r, std::vector<Renderabl
 	}
 }
 
+/**
+ * addLights()
+ * Collect the lights of all hazards for MapRenderer
+ */
+void HazardManager::addLights(std::vector<LightSource> &lights) {
+	for (unsigned int i=0; i<h.size(); i++) {
+		h[i]->addLight(lights);
+	}
+}
+
 HazardManager::~HazardManager() {
 	for (unsigned int i = 0; i < h.size(); i++)
 		delete h[i];
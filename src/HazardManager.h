@@ -43,6 +43,7 @@ public:
 	void checkNewHazards();
 	void handleNewMap();
 	void addRenders(std::vector<Renderable> &r, std::vector<Renderable> &r_dead);
+	void addLights(std::vector<LightSource> &lights);
 
 	std::vector<Hazard*> h;
 	Enemy* last_enemy;
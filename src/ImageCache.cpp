@@ -0,0 +1,319 @@
+/*
+Copyright © 2016 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+#include "DataCache.h"
+#include "ImageCache.h"
+#include "Settings.h"
+#include "Utils.h"
+#include "UtilsFileSystem.h"
+
+#include <SDL_image.h>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// bump this whenever the layout of the cache files changes
+const uint32_t IMAGE_CACHE_VERSION = 1;
+const char IMAGE_CACHE_MAGIC[8] = "FLAREIC";
+
+/**
+ * Cache files start with this header, followed by the path of the source image
+ * and the rows of ARGB8888 pixels. Values are in host byte order.
+ */
+class ImageCacheHeader {
+public:
+	char magic[8];
+	uint32_t version;
+	uint32_t width;
+	uint32_t height;
+	uint32_t path_length;
+	uint64_t size; // of the source image file
+	uint64_t mtime;
+};
+
+/**
+ * Copy the pixels of a cache file to a new surface
+ * Returns NULL if the data isn't a complete cache file for the given source file.
+ */
+static SDL_Surface* decodeCacheFile(const char* data, size_t length, const std::string& path, uint64_t size, uint64_t mtime) {
+	ImageCacheHeader header;
+	if (length < sizeof(header))
+		return NULL;
+	memcpy(&header, data, sizeof(header));
+
+	if (memcmp(header.magic, IMAGE_CACHE_MAGIC, sizeof(header.magic)) != 0 || header.version != IMAGE_CACHE_VERSION)
+		return NULL;
+	if (header.size != size || header.mtime != mtime)
+		return NULL;
+	if (header.path_length != path.length() || length - sizeof(header) < header.path_length)
+		return NULL;
+	if (memcmp(data + sizeof(header), path.data(), path.length()) != 0)
+		return NULL;
+
+	const size_t pitch = static_cast<size_t>(header.width) * 4;
+	const size_t pixel_offset = sizeof(header) + header.path_length;
+	if (header.width == 0 || header.height == 0 || (length - pixel_offset) / pitch < header.height)
+		return NULL;
+
+	SDL_Surface* surface = SDL_CreateRGBSurface(0, header.width, header.height, 32, 0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000);
+	if (!surface)
+		return NULL;
+
+	if (SDL_MUSTLOCK(surface))
+		SDL_LockSurface(surface);
+
+	const char* src = data + pixel_offset;
+	for (uint32_t y = 0; y < header.height; ++y) {
+		memcpy(static_cast<char*>(surface->pixels) + y * surface->pitch, src + y * pitch, pitch);
+	}
+
+	if (SDL_MUSTLOCK(surface))
+		SDL_UnlockSurface(surface);
+
+	return surface;
+}
+
+ImageCache::ImageCache()
+	: cache_dir(PATH_USER + "cache/images")
+	, total_size(0)
+	, scanned(false)
+	, hits(0)
+	, misses(0) {
+}
+
+ImageCache::~ImageCache() {
+}
+
+std::string ImageCache::getCacheFile(const std::string& path) {
+	std::stringstream ss;
+	ss << cache_dir << "/" << std::hex << hashString(path) << ".bin";
+	return ss.str();
+}
+
+SDL_Surface* ImageCache::read(const std::string& cache_file, const std::string& path, uint64_t size, uint64_t mtime) {
+	SDL_Surface* surface = NULL;
+
+#ifndef _WIN32
+	int fd = open(cache_file.c_str(), O_RDONLY);
+	if (fd < 0)
+		return NULL;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+		close(fd);
+		return NULL;
+	}
+
+	const size_t length = static_cast<size_t>(st.st_size);
+	void* data = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (data == MAP_FAILED)
+		return NULL;
+
+	surface = decodeCacheFile(static_cast<const char*>(data), length, path, size, mtime);
+	munmap(data, length);
+#else
+	std::ifstream infile(cache_file.c_str(), std::ios::in | std::ios::binary);
+	if (!infile.is_open())
+		return NULL;
+
+	infile.seekg(0, std::ios::end);
+	std::streamoff length = infile.tellg();
+	infile.seekg(0, std::ios::beg);
+
+	if (length > 0) {
+		std::vector<char> buf(static_cast<size_t>(length));
+		infile.read(&buf[0], length);
+		if (infile.good())
+			surface = decodeCacheFile(&buf[0], buf.size(), path, size, mtime);
+	}
+	infile.close();
+#endif
+
+	return surface;
+}
+
+void ImageCache::write(const std::string& cache_file, const std::string& path, uint64_t size, uint64_t mtime, SDL_Surface* surface) {
+	const uint64_t pitch = static_cast<uint64_t>(surface->w) * 4;
+	const uint64_t file_size = sizeof(ImageCacheHeader) + path.length() + pitch * surface->h;
+	const uint64_t max_size = static_cast<uint64_t>(IMAGE_CACHE) * 1024 * 1024;
+
+	if (file_size > max_size)
+		return;
+
+	scan();
+
+	// the file is replaced if the source image was changed
+	for (size_t i = 0; i < files.size(); ++i) {
+		if (files[i].path == cache_file) {
+			total_size -= std::min(files[i].size, total_size);
+			files.erase(files.begin() + i);
+			break;
+		}
+	}
+
+	if (total_size + file_size > max_size)
+		evict(total_size + file_size - max_size);
+
+	createDir(PATH_USER + "cache");
+	createDir(cache_dir);
+
+	std::ofstream outfile(cache_file.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!outfile.is_open())
+		return;
+
+	ImageCacheHeader header;
+	memcpy(header.magic, IMAGE_CACHE_MAGIC, sizeof(header.magic));
+	header.version = IMAGE_CACHE_VERSION;
+	header.width = static_cast<uint32_t>(surface->w);
+	header.height = static_cast<uint32_t>(surface->h);
+	header.path_length = static_cast<uint32_t>(path.length());
+	header.size = size;
+	header.mtime = mtime;
+
+	outfile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	outfile.write(path.data(), path.length());
+
+	if (SDL_MUSTLOCK(surface))
+		SDL_LockSurface(surface);
+
+	for (int y = 0; y < surface->h; ++y) {
+		outfile.write(static_cast<const char*>(surface->pixels) + y * surface->pitch, static_cast<std::streamsize>(pitch));
+	}
+
+	if (SDL_MUSTLOCK(surface))
+		SDL_UnlockSurface(surface);
+
+	bool write_ok = outfile.good();
+	outfile.close();
+
+	if (!write_ok) {
+		logError("ImageCache: Unable to write '%s'. No write access or disk is full!", cache_file.c_str());
+		removeFile(cache_file);
+		return;
+	}
+
+	ImageCacheFile f;
+	f.path = cache_file;
+	f.size = file_size;
+	f.mtime = 0;
+	getFileInfo(cache_file, f.size, f.mtime);
+	files.push_back(f);
+	total_size += f.size;
+}
+
+/**
+ * Collect the cache files left by previous runs, needed to keep the cache below its size limit
+ */
+void ImageCache::scan() {
+	if (scanned)
+		return;
+
+	scanned = true;
+
+	std::vector<std::string> cache_files;
+	getFileList(cache_dir, ".bin", cache_files);
+
+	for (size_t i = 0; i < cache_files.size(); ++i) {
+		ImageCacheFile f;
+		f.path = cache_files[i];
+		if (!getFileInfo(f.path, f.size, f.mtime))
+			continue;
+
+		files.push_back(f);
+		total_size += f.size;
+	}
+}
+
+/**
+ * Delete the least recently used cache files until at least the given number of bytes are freed
+ */
+void ImageCache::evict(uint64_t needed) {
+	uint64_t freed = 0;
+
+	while (freed < needed && !files.empty()) {
+		size_t oldest = 0;
+		for (size_t i = 1; i < files.size(); ++i) {
+			if (files[i].mtime < files[oldest].mtime)
+				oldest = i;
+		}
+
+		removeFile(files[oldest].path);
+		freed += files[oldest].size;
+		total_size -= std::min(files[oldest].size, total_size);
+		files.erase(files.begin() + oldest);
+	}
+}
+
+/**
+ * The file modification time doubles as the last access time, since it is kept across runs
+ */
+void ImageCache::markUsed(const std::string& cache_file) {
+	if (!touchFile(cache_file))
+		return;
+
+	for (size_t i = 0; i < files.size(); ++i) {
+		if (files[i].path == cache_file) {
+			uint64_t size = 0;
+			getFileInfo(cache_file, size, files[i].mtime);
+			break;
+		}
+	}
+}
+
+/**
+ * Load the image file at the given (already located) path
+ * The returned surface is owned by the caller. If it isn't cached, the image is
+ * decoded with SDL_image and returned as ARGB8888, so IMG_GetError() can be used
+ * when this returns NULL.
+ */
+SDL_Surface* ImageCache::load(const std::string& path) {
+	uint64_t size = 0;
+	uint64_t mtime = 0;
+
+	if (IMAGE_CACHE <= 0 || !getFileInfo(path, size, mtime))
+		return IMG_Load(path.c_str());
+
+	const std::string cache_file = getCacheFile(path);
+
+	SDL_Surface* surface = read(cache_file, path, size, mtime);
+	if (surface) {
+		++hits;
+		markUsed(cache_file);
+		return surface;
+	}
+
+	++misses;
+
+	SDL_Surface* cleanup = IMG_Load(path.c_str());
+	if (!cleanup)
+		return NULL;
+
+	surface = SDL_ConvertSurfaceFormat(cleanup, SDL_PIXELFORMAT_ARGB8888, 0);
+	SDL_FreeSurface(cleanup);
+	if (!surface)
+		return NULL;
+
+	write(cache_file, path, size, mtime, surface);
+	return surface;
+}
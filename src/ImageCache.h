@@ -0,0 +1,68 @@
+/*
+Copyright © 2016 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+/**
+ * class ImageCache
+ *
+ * Stores decoded images as raw 32-bit ARGB pixels in PATH_USER, one file per
+ * image, so that the render devices don't have to inflate and unfilter the same
+ * PNG files on every launch and map change. Entries are keyed by the path of the
+ * image file, and are only used while its size and modification time match.
+ *
+ * Cache files are read with mmap where available. Each hit sets the file's
+ * modification time to now, so once the cache grows past IMAGE_CACHE megabytes,
+ * the least recently used files are deleted.
+ */
+
+#ifndef IMAGE_CACHE_H
+#define IMAGE_CACHE_H
+
+#include "CommonIncludes.h"
+#include <stdint.h>
+
+class ImageCacheFile {
+public:
+	std::string path;
+	uint64_t size;
+	uint64_t mtime; // the last time the file was written or used
+};
+
+class ImageCache {
+private:
+	std::string getCacheFile(const std::string& path);
+	SDL_Surface* read(const std::string& cache_file, const std::string& path, uint64_t size, uint64_t mtime);
+	void write(const std::string& cache_file, const std::string& path, uint64_t size, uint64_t mtime, SDL_Surface* surface);
+	void scan();
+	void evict(uint64_t needed);
+	void markUsed(const std::string& cache_file);
+
+	std::string cache_dir;
+	std::vector<ImageCacheFile> files; // the cache files on disk, only filled once something is written
+	uint64_t total_size;
+	bool scanned;
+
+public:
+	ImageCache();
+	~ImageCache();
+
+	SDL_Surface* load(const std::string& path);
+
+	unsigned hits;
+	unsigned misses;
+};
+
+#endif
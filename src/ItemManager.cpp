@@ -102,7 +102,8 @@ void ItemManager::loadItems(const std::string& filename, bool locateFileName) {
 	FileParser infile;
 
 	// @CLASS ItemManager: Items|Description about the class and it usage, items/items.txt...
-	if (!infile.open(filename, locateFileName))
+	bool is_open = locateFileName ? infile.openCached(filename) : infile.open(filename, false);
+	if (!is_open)
 		return;
 
 	// used to clear vectors when overriding items
@@ -325,7 +326,8 @@ void ItemManager::loadTypes(const std::string& filename, bool locateFileName) {
 	FileParser infile;
 
 	// @CLASS ItemManager: Types|Definition of a item types, items/types.txt...
-	if (infile.open(filename, locateFileName)) {
+	bool is_open = locateFileName ? infile.openCached(filename) : infile.open(filename, false);
+	if (is_open) {
 		while (infile.next()) {
 			if (infile.new_section) {
 				if (infile.section == "type") {
@@ -367,7 +369,8 @@ void ItemManager::loadQualities(const std::string& filename, bool locateFileName
 	FileParser infile;
 
 	// @CLASS ItemManager: Qualities|Definition of a item qualities, items/types.txt...
-	if (infile.open(filename, locateFileName)) {
+	bool is_open = locateFileName ? infile.openCached(filename) : infile.open(filename, false);
+	if (is_open) {
 		while (infile.next()) {
 			if (infile.new_section) {
 				if (infile.section == "quality") {
@@ -455,7 +458,8 @@ void ItemManager::loadSets(const std::string& filename, bool locateFileName) {
 	FileParser infile;
 
 	// @CLASS ItemManager: Sets|Definition of a item sets, items/sets.txt...
-	if (!infile.open(filename, locateFileName))
+	bool is_open = locateFileName ? infile.openCached(filename) : infile.open(filename, false);
+	if (!is_open)
 		return;
 
 	bool clear_bonus = true;
@@ -0,0 +1,286 @@
+/*
+Copyright © 2016 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+#include "JobSystem.h"
+#include "Utils.h"
+
+#include <stdint.h>
+
+JobCounter::JobCounter()
+	: waiting() {
+	SDL_AtomicSet(&pending, 0);
+}
+
+/**
+ * True once all jobs counted by this counter have finished
+ */
+bool JobCounter::isDone() {
+	return SDL_AtomicGet(&pending) == 0;
+}
+
+/**
+ * thread_count includes the thread that waits for jobs, so 1 runs every job right
+ * away on the calling thread. 0 uses one thread per CPU core.
+ */
+JobSystem::JobSystem(int thread_count)
+	: queue_index(SDL_TLSCreate())
+	, counter_lock(SDL_CreateMutex())
+	, wake_lock(SDL_CreateMutex())
+	, work_available(SDL_CreateCond())
+	, work_done(SDL_CreateCond())
+	, queued_jobs(0)
+	, waiting_threads(0)
+	, quit(false) {
+	SDL_AtomicSet(&started_workers, 0);
+
+	if (thread_count <= 0)
+		thread_count = SDL_GetCPUCount();
+
+#ifdef NO_THREADS
+	thread_count = 1;
+#endif
+
+	// the queues must all exist before the first worker starts
+	queues.resize(std::max(thread_count, 1));
+	for (size_t i = 0; i < queues.size(); ++i) {
+		queues[i].lock = SDL_CreateMutex();
+	}
+
+#ifndef NO_THREADS
+	for (int i = 1; i < thread_count; ++i) {
+		SDL_Thread* thread = SDL_CreateThread(workerThread, "jobs", this);
+		if (!thread) {
+			logError("JobSystem: Unable to create worker thread: %s", SDL_GetError());
+			break;
+		}
+		threads.push_back(thread);
+	}
+#endif
+
+	logInfo("JobSystem: Running jobs with %d threads.", getThreadCount());
+}
+
+JobSystem::~JobSystem() {
+	SDL_LockMutex(wake_lock);
+	quit = true;
+	SDL_CondBroadcast(work_available);
+	SDL_UnlockMutex(wake_lock);
+
+	for (size_t i = 0; i < threads.size(); ++i) {
+		SDL_WaitThread(threads[i], NULL);
+	}
+
+	for (size_t i = 0; i < queues.size(); ++i) {
+		SDL_DestroyMutex(queues[i].lock);
+	}
+
+	SDL_DestroyMutex(counter_lock);
+	SDL_DestroyMutex(wake_lock);
+	SDL_DestroyCond(work_available);
+	SDL_DestroyCond(work_done);
+}
+
+int JobSystem::getThreadCount() const {
+	return static_cast<int>(threads.size()) + 1;
+}
+
+/**
+ * Queue a job for the worker threads
+ * The job is counted by counter, if given. If after is given, the job only starts once
+ * all jobs of that counter are done.
+ */
+void JobSystem::run(Job* job, JobCounter* counter, JobCounter* after) {
+	JobEntry entry;
+	entry.job = job;
+	entry.counter = counter;
+
+	SDL_LockMutex(counter_lock);
+
+	if (counter)
+		SDL_AtomicIncRef(&counter->pending);
+
+	// it is queued by execute() when the last job of after is done
+	if (after && !after->isDone()) {
+		after->waiting.push_back(entry);
+		SDL_UnlockMutex(counter_lock);
+		return;
+	}
+
+	SDL_UnlockMutex(counter_lock);
+
+	push(entry);
+}
+
+/**
+ * Wait until all jobs of the counter are done
+ * The waiting thread runs queued jobs in the meantime, so this can be called from
+ * jobs too.
+ */
+void JobSystem::wait(JobCounter* counter) {
+	const int index = getQueueIndex();
+
+	while (!counter->isDone()) {
+		JobEntry entry;
+		if (pop(index, entry)) {
+			execute(entry);
+		}
+		else {
+			// the remaining jobs are running on other threads. Sleep until one of them
+			// finishes or queues more work. Both happen under wake_lock, so nothing is
+			// missed between these checks and SDL_CondWait().
+			SDL_LockMutex(wake_lock);
+			++waiting_threads;
+			while (!counter->isDone() && queued_jobs == 0) {
+				SDL_CondWait(work_done, wake_lock);
+			}
+			--waiting_threads;
+			SDL_UnlockMutex(wake_lock);
+		}
+	}
+}
+
+/**
+ * The queue of the calling thread: its own for workers, otherwise queue 0
+ */
+int JobSystem::getQueueIndex() {
+	return static_cast<int>(reinterpret_cast<intptr_t>(SDL_TLSGet(queue_index)));
+}
+
+void JobSystem::push(const JobEntry& entry) {
+	// without workers, nothing else could run the job
+	if (threads.empty()) {
+		execute(entry);
+		return;
+	}
+
+	JobQueue& queue = queues[getQueueIndex()];
+	SDL_LockMutex(queue.lock);
+	queue.jobs.push_back(entry);
+
+	// one idle worker is enough, but every waiting thread may help with the job
+	SDL_LockMutex(wake_lock);
+	++queued_jobs;
+	SDL_CondSignal(work_available);
+	if (waiting_threads > 0)
+		SDL_CondBroadcast(work_done);
+	SDL_UnlockMutex(wake_lock);
+
+	SDL_UnlockMutex(queue.lock);
+}
+
+/**
+ * Take an entry out of a queue, whose lock is held by the caller
+ */
+void JobSystem::take(JobQueue& queue, bool from_back, JobEntry& entry) {
+	if (from_back) {
+		entry = queue.jobs.back();
+		queue.jobs.pop_back();
+	}
+	else {
+		entry = queue.jobs.front();
+		queue.jobs.pop_front();
+	}
+
+	SDL_LockMutex(wake_lock);
+	--queued_jobs;
+	SDL_UnlockMutex(wake_lock);
+}
+
+/**
+ * Take the newest job of the own queue, or else steal the oldest job of another queue
+ */
+bool JobSystem::pop(int index, JobEntry& entry) {
+	JobQueue& own = queues[index];
+	SDL_LockMutex(own.lock);
+	if (!own.jobs.empty()) {
+		take(own, true, entry);
+		SDL_UnlockMutex(own.lock);
+		return true;
+	}
+	SDL_UnlockMutex(own.lock);
+
+	for (size_t i = 1; i < queues.size(); ++i) {
+		JobQueue& other = queues[(static_cast<size_t>(index) + i) % queues.size()];
+		SDL_LockMutex(other.lock);
+		if (!other.jobs.empty()) {
+			take(other, false, entry);
+			SDL_UnlockMutex(other.lock);
+			return true;
+		}
+		SDL_UnlockMutex(other.lock);
+	}
+
+	return false;
+}
+
+/**
+ * Run a job, then start the jobs that were waiting for its counter
+ */
+void JobSystem::execute(const JobEntry& entry) {
+	entry.job->run();
+
+	if (!entry.counter)
+		return;
+
+	std::vector<JobEntry> ready;
+
+	// the counter is only changed under counter_lock, so this is the last job when it
+	// counts 1. It must not be touched after the decrement: a waiting thread can see
+	// it done and let it go out of scope.
+	SDL_LockMutex(counter_lock);
+	if (SDL_AtomicGet(&entry.counter->pending) == 1)
+		ready.swap(entry.counter->waiting);
+	SDL_AtomicAdd(&entry.counter->pending, -1);
+	SDL_UnlockMutex(counter_lock);
+
+	for (size_t i = 0; i < ready.size(); ++i) {
+		push(ready[i]);
+	}
+
+	SDL_LockMutex(wake_lock);
+	if (waiting_threads > 0)
+		SDL_CondBroadcast(work_done);
+	SDL_UnlockMutex(wake_lock);
+}
+
+int JobSystem::workerThread(void* data) {
+	JobSystem* system = static_cast<JobSystem*>(data);
+
+	// workers take the queues after queue 0, in the order they start
+	const int index = SDL_AtomicAdd(&system->started_workers, 1) + 1;
+	SDL_TLSSet(system->queue_index, reinterpret_cast<void*>(static_cast<intptr_t>(index)), NULL);
+
+	while (true) {
+		JobEntry entry;
+		if (system->pop(index, entry)) {
+			system->execute(entry);
+			continue;
+		}
+
+		SDL_LockMutex(system->wake_lock);
+		while (system->queued_jobs == 0 && !system->quit) {
+			SDL_CondWait(system->work_available, system->wake_lock);
+		}
+		const bool quit = system->quit;
+		SDL_UnlockMutex(system->wake_lock);
+
+		if (quit)
+			break;
+	}
+
+	return 0;
+}
@@ -0,0 +1,110 @@
+/*
+Copyright © 2016 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+/**
+ * class JobSystem
+ *
+ * Runs jobs on a fixed pool of worker threads. Every worker has its own queue.
+ * Jobs queued by a worker go to the back of its own queue and are taken from
+ * there first. A worker with an empty queue steals from the front of the others.
+ *
+ * A JobCounter is the handle of a group of jobs. It counts the jobs that haven't
+ * finished yet, and other jobs can be made to wait for it. Jobs run on any thread,
+ * so they must not use SDL or the render device.
+ *
+ * Jobs are owned by the caller, and must stay alive until their counter is done.
+ * Built with NO_THREADS (or with job_threads=1), there are no workers and jobs
+ * run right away on the calling thread.
+ */
+
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include "CommonIncludes.h"
+
+#include <deque>
+
+class Job {
+public:
+	virtual ~Job() {}
+	virtual void run() = 0;
+};
+
+class JobCounter;
+
+class JobEntry {
+public:
+	Job* job;
+	JobCounter* counter;
+};
+
+class JobCounter {
+public:
+	JobCounter();
+
+	bool isDone();
+
+private:
+	friend class JobSystem;
+
+	SDL_atomic_t pending;
+	std::vector<JobEntry> waiting; // jobs that start when this counter is done
+};
+
+class JobQueue {
+public:
+	SDL_mutex* lock;
+	std::deque<JobEntry> jobs;
+};
+
+class JobSystem {
+private:
+	static int workerThread(void* data);
+	int getQueueIndex();
+	void push(const JobEntry& entry);
+	void take(JobQueue& queue, bool from_back, JobEntry& entry);
+	bool pop(int index, JobEntry& entry);
+	void execute(const JobEntry& entry);
+
+	std::vector<SDL_Thread*> threads;
+	std::vector<JobQueue> queues; // queue 0 is used by threads that aren't workers, the rest by one worker each
+
+	SDL_TLSID queue_index;
+	SDL_atomic_t started_workers;
+
+	SDL_mutex* counter_lock;
+
+	// queued_jobs counts the entries of all queues. It is only changed while holding
+	// wake_lock and the lock of the queue.
+	SDL_mutex* wake_lock;
+	SDL_cond* work_available; // signaled for idle workers
+	SDL_cond* work_done; // broadcast for threads in wait()
+	int queued_jobs;
+	int waiting_threads;
+	bool quit;
+
+public:
+	explicit JobSystem(int thread_count);
+	~JobSystem();
+
+	int getThreadCount() const;
+
+	void run(Job* job, JobCounter* counter = NULL, JobCounter* after = NULL);
+	void wait(JobCounter* counter);
+};
+
+#endif
@@ -55,7 +55,7 @@ LootManager::LootManager()
 	FileParser infile;
 	// load loot animation settings from engine config file
 	// @CLASS Loot|Description of engine/loot.txt
-	if (infile.open("engine/loot.txt")) {
+	if (infile.openCached("engine/loot.txt")) {
 		while (infile.next()) {
 			if (infile.key == "tooltip_margin") {
 				// @ATTR tooltip_margin|int|Vertical offset of the loot tooltip from the loot itself.
@@ -212,6 +212,14 @@ void LootManager::checkEnemiesForLoot() {
 	for (unsigned i=0; i < enemiesDroppingLoot.size(); ++i) {
 		Enemy *e = enemiesDroppingLoot[i];
 
+		if (e->stats.loot_dropped)
+			continue;
+		e->stats.loot_dropped = true;
+
+		// checkLoot() removes the fixed drops from the table, and the loot table of
+		// the definition is shared with the other enemies of this type
+		std::vector<Event_Component> loot_table = e->stats.def->loot_table;
+
 		if (e->stats.quest_loot_id != 0) {
 			// quest loot
 			Event_Component ec;
@@ -220,23 +228,21 @@ void LootManager::checkEnemiesForLoot() {
 			ec.a = ec.b = 1;
 			ec.z = 0;
 
-			e->stats.loot_table.push_back(ec);
+			loot_table.push_back(ec);
 		}
 
-		if (!e->stats.loot_table.empty()) {
+		if (!loot_table.empty()) {
 			unsigned drops;
-			if (e->stats.loot_count.y != 0) {
-				drops = randBetween(e->stats.loot_count.x, e->stats.loot_count.y);
+			if (e->stats.def->loot_count.y != 0) {
+				drops = randBetween(e->stats.def->loot_count.x, e->stats.def->loot_count.y);
 			}
 			else {
 				drops = randBetween(1, drop_max);
 			}
 
 			for (unsigned j=0; j<drops; ++j) {
-				checkLoot(e->stats.loot_table, &e->stats.pos);
+				checkLoot(loot_table, &e->stats.pos);
 			}
-
-			e->stats.loot_table.clear();
 		}
 	}
 	enemiesDroppingLoot.clear();
@@ -447,39 +453,64 @@ void LootManager::addLoot(ItemStack stack, const FPoint& pos, bool dropped_by_he
  * Click on the map to pick up loot.  We need the camera position to translate
  * screen coordinates to map locations.
  */
-ItemStack LootManager::checkPickup(const Point& mouse, const FPoint& cam, const FPoint& hero_pos) {
-	Rect r;
+bool LootManager::isInPickupRange(Loot& l, const FPoint& hero_pos) {
+	return fabs(hero_pos.x - l.pos.x) < INTERACT_RANGE && fabs(hero_pos.y - l.pos.y) < INTERACT_RANGE && !l.isFlying();
+}
+
+/**
+ * The loot under the mouse that is close enough to pick up, or loot.end()
+ * Loot labels are drawn over all sprites, so they are checked first. Then the loot
+ * sprites are checked from the top down, in the order they were drawn in the last frame.
+ */
+std::vector<Loot>::iterator LootManager::getLootAtMouse(const Point& mouse, const FPoint& hero_pos) {
+	std::vector<Loot>::iterator it;
+	for (it = loot.end(); it != loot.begin(); ) {
+		--it;
+		if (it->tip_visible && isWithinRect(it->tip_bounds, mouse) && isInPickupRange(*it, hero_pos))
+			return it;
+	}
+
+	const std::vector<PickBounds>& pick_list = mapr->getPickList();
+	for (size_t i = pick_list.size(); i > 0; --i) {
+		const PickBounds& pb = pick_list[i-1];
+		if (pb.type != PICK_LOOT)
+			continue;
+
+		// the pickup hotspot is the sprite or the tile below it
+		Rect r;
+		r.x = pb.pos.x - TILE_W_HALF;
+		r.y = pb.pos.y - TILE_H_HALF;
+		r.w = TILE_W;
+		r.h = TILE_H;
+		if (!isWithinRect(pb.bounds, mouse) && !isWithinRect(r, mouse))
+			continue;
+
+		// loot may have been picked up since it was drawn, which moves the loot after it
+		if (pb.index >= loot.size())
+			continue;
+
+		it = loot.begin() + pb.index;
+		if (it->pos.x == pb.map_pos.x && it->pos.y == pb.map_pos.y && isInPickupRange(*it, hero_pos))
+			return it;
+	}
+
+	return loot.end();
+}
+
+ItemStack LootManager::checkPickup(const Point& mouse, const FPoint& hero_pos) {
 	ItemStack loot_stack;
 
 	// check left mouse click
 	if (inpt->usingMouse()) {
-		// I'm starting at the end of the loot list so that more recently-dropped
-		// loot is picked up first.  If a player drops several loot in the same
-		// location, picking it back up will work like a stack.
-		std::vector<Loot>::iterator it;
-		for (it = loot.end(); it != loot.begin(); ) {
-			--it;
-
-			// loot close enough to pickup?
-			if (fabs(hero_pos.x - it->pos.x) < INTERACT_RANGE && fabs(hero_pos.y - it->pos.y) < INTERACT_RANGE && !it->isFlying()) {
-				Point p = map_to_screen(it->pos.x, it->pos.y, cam.x, cam.y);
-
-				r.x = p.x - TILE_W_HALF;
-				r.y = p.y - TILE_H_HALF;
-				r.w = TILE_W;
-				r.h = TILE_H;
-
-				// clicked in pickup hotspot?
-				if ((it->tip_visible && isWithinRect(it->tip_bounds, mouse)) || isWithinRect(r, mouse)) {
-					curs->setCursor(CURSOR_INTERACT);
-					if (inpt->pressing[MAIN1] && !inpt->lock[MAIN1]) {
-						inpt->lock[MAIN1] = true;
-						if (!it->stack.empty()) {
-							loot_stack = it->stack;
-							it = loot.erase(it);
-							return loot_stack;
-						}
-					}
+		std::vector<Loot>::iterator it = getLootAtMouse(mouse, hero_pos);
+		if (it != loot.end()) {
+			curs->setCursor(CURSOR_INTERACT);
+			if (inpt->pressing[MAIN1] && !inpt->lock[MAIN1]) {
+				inpt->lock[MAIN1] = true;
+				if (!it->stack.empty()) {
+					loot_stack = it->stack;
+					loot.erase(it);
+					return loot_stack;
 				}
 			}
 		}
@@ -548,11 +579,14 @@ void LootManager::addRenders(std::vector<Renderable> &ren, std::vector<Renderabl
 	std::vector<Loot>::iterator it;
 	for (it = loot.begin(); it != loot.end(); ++it) {
 		if (it->animation) {
-			Renderable r = it->animation->getCurrentFrame(0);
+			std::vector<Renderable>& queue = (it->animation->isLastFrame() ? ren_dead : ren);
+			queue.resize(queue.size()+1);
+			Renderable& r = queue.back();
+			it->animation->getCurrentFrame(0, r);
 			r.map_pos.x = it->pos.x;
 			r.map_pos.y = it->pos.y;
-
-			(it->animation->isLastFrame() ? ren_dead : ren).push_back(r);
+			r.pick_type = PICK_LOOT;
+			r.pick_index = static_cast<size_t>(it - loot.begin());
 		}
 	}
 }
@@ -634,7 +668,7 @@ void LootManager::loadLootTables() {
 
 	for (unsigned i=0; i<filenames.size(); i++) {
 		FileParser infile;
-		if (!infile.open(filenames[i]))
+		if (!infile.openCached(filenames[i]))
 			continue;
 
 		std::vector<Event_Component> *ec_list = &loot_tables[filenames[i]];
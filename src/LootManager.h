@@ -56,6 +56,8 @@ private:
 	void checkMapForLoot();
 	void loadLootTables();
 	void getLootTable(const std::string &filename, std::vector<Event_Component> *ec_list);
+	bool isInPickupRange(Loot& l, const FPoint& hero_pos);
+	std::vector<Loot>::iterator getLootAtMouse(const Point& mouse, const FPoint& hero_pos);
 
 	SoundManager::SoundID sfx_loot;
 
@@ -89,7 +91,7 @@ public:
 	void addEnemyLoot(Enemy *e);
 	void addLoot(ItemStack stack, const FPoint& pos, bool dropped_by_hero = false);
 	void checkLoot(std::vector<Event_Component> &loot_table, FPoint *pos = NULL, std::vector<ItemStack> *itemstack_vec = NULL);
-	ItemStack checkPickup(const Point& mouse, const FPoint& cam, const FPoint& hero_pos);
+	ItemStack checkPickup(const Point& mouse, const FPoint& hero_pos);
 	ItemStack checkAutoPickup(const FPoint& hero_pos);
 	ItemStack checkNearestPickup(const FPoint& hero_pos);
 
@@ -33,7 +33,9 @@ Map::Map()
 	, w(1)
 	, h(1)
 	, hero_pos_enabled(false)
-	, hero_pos() {
+	, hero_pos()
+	, lighting(false)
+	, ambient_light(255, 255, 255) {
 }
 
 Map::~Map() {
@@ -52,6 +54,7 @@ void Map::clearQueues() {
 
 void Map::clearEvents() {
 	events.clear();
+	event_index.invalidate();
 	statblocks.clear();
 }
 
@@ -75,6 +78,8 @@ int Map::load(const std::string& fname) {
 	hero_pos_enabled = false;
 	hero_pos.x = 0;
 	hero_pos.y = 0;
+	lighting = false;
+	ambient_light = Color(255, 255, 255);
 
 	// @CLASS Map|Description of maps/
 	if (!infile.open(fname))
@@ -110,6 +115,8 @@ int Map::load(const std::string& fname) {
 
 	// create StatBlocks for events that need powers
 	for (unsigned i=0; i<events.size(); ++i) {
+		EventManager::compileConditions(events[i]);
+
 		Event_Component *ec_power = events[i].getComponent(EC_POWER);
 		if (ec_power) {
 			// store the index of this StatBlock so that we can find it when the event is activated
@@ -162,6 +169,11 @@ void Map::loadHeader(FileParser &infile) {
 		hero_pos.y = static_cast<float>(popFirstInt(infile.val)) + 0.5f;
 		hero_pos_enabled = true;
 	}
+	else if (infile.key == "ambient_light") {
+		// @ATTR ambient_light|color|Darkens the map to this color. Only maps with an ambient light level show the lights of events and powers.
+		ambient_light = toRGB(infile.val);
+		lighting = true;
+	}
 	else if (infile.key == "tilewidth") {
 		// @ATTR tilewidth|int|Inherited from Tiled map file. Unused by engine.
 	}
@@ -24,6 +24,7 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include <vector>
 #include <queue>
 
+#include "EventIndex.h"
 #include "EventManager.h"
 #include "FileParser.h"
 #include "MapCollision.h"
@@ -155,6 +156,7 @@ public:
 
 	// map events
 	std::vector<Event> events;
+	EventIndex event_index;
 
 	// vars
 	std::string title;
@@ -163,6 +165,10 @@ public:
 	bool hero_pos_enabled;
 	FPoint hero_pos;
 
+	// maps without an ambient light level are not darkened, and their lights are not drawn
+	bool lighting;
+	Color ambient_light;
+
 };
 
 #endif // MAP_H
@@ -35,6 +35,7 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 
 MapCollision::MapCollision()
 	: map_size(Point())
+	, revision(0)
 {
 	colmap.resize(1);
 	colmap[0].resize(1);
@@ -51,6 +52,18 @@ void MapCollision::setmap(const Map_Layer& _colmap, unsigned short w, unsigned s
 
 	map_size.x = w;
 	map_size.y = h;
+
+	revision++;
+}
+
+/**
+ * Change the collision type of a tile, e.g. by a map event
+ */
+void MapCollision::set_tile(int tile_x, int tile_y, unsigned short type) {
+	if (is_outside_map(tile_x, tile_y)) return;
+
+	colmap[tile_x][tile_y] = type;
+	revision++;
 }
 
 int sgn(float f) {
@@ -373,28 +386,24 @@ bool MapCollision::is_facing(const float& x1, const float& y1, char direction, c
 * limit is the maximum number of explored node
 * @return true if a path is found
 */
-bool MapCollision::compute_path(const FPoint& start_pos, const FPoint& end_pos, std::vector<FPoint> &path, MOVEMENTTYPE movement_type, unsigned int limit) {
+bool MapCollision::compute_path(const FPoint& start_pos, const FPoint& end_pos, std::vector<FPoint> &path, MOVEMENTTYPE movement_type, unsigned int limit) const {
+
+	// path must be empty, also when no path is found
+	if (!path.empty())
+		path.clear();
 
 	if (is_outside_map(end_pos.x, end_pos.y)) return false;
 
 	if (limit == 0)
 		limit = std::max(map_size.x, map_size.y);
 
-	// path must be empty
-	if (!path.empty())
-		path.clear();
-
 	// convert start & end to MapCollision precision
 	Point start = map_to_collision(start_pos);
 	Point end = map_to_collision(end_pos);
 
-	// if the target square has an entity, temporarily clear it to compute the path
-	bool target_blocks = false;
-	int target_blocks_type = colmap[end.x][end.y];
-	if (colmap[end.x][end.y] == BLOCKS_ENTITIES || colmap[end.x][end.y] == BLOCKS_ENEMIES) {
-		target_blocks = true;
-		unblock(end_pos.x, end_pos.y);
-	}
+	// if the target square has an entity, it is treated as empty to compute the path
+	// colmap is left untouched, so that several paths can be computed at the same time
+	const bool target_blocks = (colmap[end.x][end.y] == BLOCKS_ENTITIES || colmap[end.x][end.y] == BLOCKS_ENEMIES);
 
 	Point current = start;
 	AStarNode* node = new AStarNode(start);
@@ -431,7 +440,7 @@ bool MapCollision::compute_path(const FPoint& start_pos, const FPoint& end_pos,
 			}
 
 			// if neighbour is not free of any collision, skip it
-			if (!is_valid_tile(neighbour.x,neighbour.y,movement_type, false))
+			if (!is_valid_tile(neighbour.x,neighbour.y,movement_type, false) && !(target_blocks && neighbour.x == end.x && neighbour.y == end.y))
 				continue;
 			// if nabour is already in close, skip it
 			if(close.exists(neighbour))
@@ -477,9 +486,6 @@ bool MapCollision::compute_path(const FPoint& start_pos, const FPoint& end_pos,
 			current = close.get(current.x, current.y)->getParent();
 		}
 	}
-	// reblock target if needed
-	if (target_blocks) block(end_pos.x, end_pos.y, target_blocks_type == BLOCKS_ENEMIES);
-
 	return !path.empty();
 }
 
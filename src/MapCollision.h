@@ -94,15 +94,19 @@ public:
 
 	bool is_facing(const float& x1, const float& y1, char direction, const float& x2, const float& y2);
 
-	bool compute_path(const FPoint& start, const FPoint& end, std::vector<FPoint> &path, MOVEMENTTYPE movement_type, unsigned int limit = 0);
+	bool compute_path(const FPoint& start, const FPoint& end, std::vector<FPoint> &path, MOVEMENTTYPE movement_type, unsigned int limit = 0) const;
 
 	void block(const float& map_x, const float& map_y, bool is_ally);
 	void unblock(const float& map_x, const float& map_y);
+	void set_tile(int tile_x, int tile_y, unsigned short type);
 
 	FPoint get_random_neighbor(const Point& target, int range, bool ignore_blocked = false);
 
 	Map_Layer colmap;
 	Point map_size;
+
+	// changed whenever the walls of the map may have changed, so that cached sight lines can be dropped
+	unsigned revision;
 };
 
 #endif
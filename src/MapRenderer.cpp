@@ -42,7 +42,8 @@ MapRenderer::MapRenderer()
 	, show_tooltip(false)
 	, shakycam()
 	, cam()
-	, map_change(false)
+	, prev_cam()
+	, interpolation(1)
 	, teleportation(false)
 	, teleport_destination()
 	, respawn_point()
@@ -59,6 +60,16 @@ MapRenderer::MapRenderer()
 {
 }
 
+/**
+ * The position to draw something at that moved from prev to cur in the current logic frame
+ */
+FPoint MapRenderer::interpolate(const FPoint& prev, const FPoint& cur) const {
+	// anything that moved further than this was teleported, so it shouldn't slide there
+	const float max_dist = 2;
+
+	return interpolatePoint(prev, cur, interpolation, max_dist);
+}
+
 void MapRenderer::clearQueues() {
 	Map::clearQueues();
 	loot.clear();
@@ -163,6 +174,9 @@ int MapRenderer::load(const std::string& fname) {
 
 	show_tooltip = false;
 
+	// the picked objects are deleted along with the old map
+	pick_list.clear();
+
 	Map::load(fname);
 
 	loadMusic();
@@ -276,7 +290,60 @@ void calculatePriosOrtho(std::vector<Renderable> &r) {
 	}
 }
 
-void MapRenderer::render(std::vector<Renderable> &r, std::vector<Renderable> &r_dead) {
+/**
+ * Lights closer to the center of the screen are kept when there are too many of them
+ */
+bool lightcompare(const RenderLight &l1, const RenderLight &l2) {
+	int dx1 = l1.pos.x - VIEW_W_HALF;
+	int dy1 = l1.pos.y - VIEW_H_HALF;
+	int dx2 = l2.pos.x - VIEW_W_HALF;
+	int dy2 = l2.pos.y - VIEW_H_HALF;
+	return dx1*dx1 + dy1*dy1 < dx2*dx2 + dy2*dy2;
+}
+
+/**
+ * Pass the visible lights of events and the given objects to the render device
+ */
+void MapRenderer::setLights(std::vector<LightSource> &lights) {
+	for (size_t i = 0; i < events.size(); ++i) {
+		if (events[i].light.radius > 0 && EventManager::isActive(events[i])) {
+			lights.push_back(events[i].light);
+			lights.back().pos = events[i].center;
+		}
+	}
+
+	// a circle on the ground is an ellipse on screen, which is sqrt(2) times wider on isometric maps
+	const float scale = (TILESET_ORIENTATION == TILESET_ISOMETRIC ? 1.41421356f : 1.0f);
+
+	render_lights.clear();
+	for (size_t i = 0; i < lights.size(); ++i) {
+		RenderLight light;
+		light.pos = map_to_screen(lights[i].pos.x, lights[i].pos.y, shakycam.x, shakycam.y);
+		light.radius.x = static_cast<int>(lights[i].radius * scale / UNITS_PER_PIXEL_X);
+		light.radius.y = static_cast<int>(lights[i].radius * scale / UNITS_PER_PIXEL_Y);
+		light.color = lights[i].color;
+
+		if (light.radius.x <= 0 || light.radius.y <= 0)
+			continue;
+		if (light.pos.x + light.radius.x < 0 || light.pos.x - light.radius.x > VIEW_W)
+			continue;
+		if (light.pos.y + light.radius.y < 0 || light.pos.y - light.radius.y > VIEW_H)
+			continue;
+
+		render_lights.push_back(light);
+	}
+
+	if (render_lights.size() > static_cast<size_t>(MAX_LIGHTS)) {
+		std::nth_element(render_lights.begin(), render_lights.begin() + MAX_LIGHTS, render_lights.end(), lightcompare);
+		render_lights.resize(MAX_LIGHTS);
+	}
+
+	render_device->setLights(ambient_light, render_lights);
+}
+
+void MapRenderer::render(std::vector<Renderable> &r, std::vector<Renderable> &r_dead, std::vector<LightSource> &lights) {
+
+	pick_list.clear();
 
 	if (shaky_cam_ticks == 0) {
 		shakycam.x = cam.x;
@@ -287,6 +354,10 @@ void MapRenderer::render(std::vector<Renderable> &r, std::vector<Renderable> &r_
 		shakycam.y = cam.y + static_cast<float>((rand() % 16 - 8)) * 0.0078125f;
 	}
 
+	const bool use_lights = (lighting && MAX_LIGHTS > 0);
+	if (use_lights)
+		setLights(lights);
+
 	if (TILESET_ORIENTATION == TILESET_ORTHOGONAL) {
 		calculatePriosOrtho(r);
 		calculatePriosOrtho(r_dead);
@@ -301,6 +372,12 @@ void MapRenderer::render(std::vector<Renderable> &r, std::vector<Renderable> &r_
 		std::sort(r_dead.begin(), r_dead.end(), priocompare);
 		renderIso(r, r_dead);
 	}
+
+	if (use_lights)
+		render_device->clearLights();
+
+	// the tooltip is UI, so it is drawn unlit
+	checkTooltip();
 }
 
 void MapRenderer::drawRenderable(std::vector<Renderable>::iterator r_cursor) {
@@ -310,7 +387,38 @@ void MapRenderer::drawRenderable(std::vector<Renderable>::iterator r_cursor) {
 		dest.x = p.x - r_cursor->offset.x;
 		dest.y = p.y - r_cursor->offset.y;
 		render_device->render(*r_cursor, dest);
+
+		if (r_cursor->pick_type != PICK_NONE) {
+			PickBounds pb;
+			pb.bounds.x = dest.x;
+			pb.bounds.y = dest.y;
+			pb.bounds.w = r_cursor->src.w;
+			pb.bounds.h = r_cursor->src.h;
+			pb.pos = p;
+			pb.map_pos = r_cursor->map_pos;
+			pb.type = r_cursor->pick_type;
+			pb.index = r_cursor->pick_index;
+			pick_list.push_back(pb);
+		}
+	}
+}
+
+/**
+ * Find the topmost sprite of the given type under the mouse, as drawn in the last frame
+ * The search starts below cursor, which is then set to the found entry. Start with
+ * cursor at getPickList().size() and call again to find the sprites further down.
+ */
+const PickBounds* MapRenderer::pick(const Point& mouse, uint8_t type, size_t& cursor) const {
+	while (cursor > 0) {
+		const PickBounds& pb = pick_list[--cursor];
+		if (pb.type == type && isWithinRect(pb.bounds, mouse))
+			return &pb;
 	}
+	return NULL;
+}
+
+const std::vector<PickBounds>& MapRenderer::getPickList() const {
+	return pick_list;
 }
 
 void MapRenderer::renderIsoLayer(const Map_Layer& layerdata) {
@@ -466,8 +574,6 @@ void MapRenderer::renderIso(std::vector<Renderable> &r, std::vector<Renderable>
 	index++;
 	while (index < layers.size())
 		renderIsoLayer(layers[index++]);
-
-	checkTooltip();
 }
 
 void MapRenderer::renderOrthoLayer(const Map_Layer& layerdata) {
@@ -565,8 +671,6 @@ void MapRenderer::renderOrtho(std::vector<Renderable> &r, std::vector<Renderable
 
 	while (index < layers.size())
 		renderOrthoLayer(layers[index++]);
-
-	checkTooltip();
 }
 
 void MapRenderer::executeOnLoadEvents() {
@@ -585,6 +689,8 @@ void MapRenderer::executeOnLoadEvents() {
 		return;
 	}
 
+	camp->checkStateChange();
+
 	std::vector<Event>::iterator it;
 
 	// loop in reverse because we may erase elements
@@ -599,9 +705,13 @@ void MapRenderer::executeOnLoadEvents() {
 				it = events.erase(it);
 		}
 	}
+
+	event_index.invalidate();
 }
 
 void MapRenderer::executeOnMapExitEvents() {
+	camp->checkStateChange();
+
 	std::vector<Event>::iterator it;
 
 	// We're leaving the map, so the events of this map are removed anyway in
@@ -618,29 +728,49 @@ void MapRenderer::executeOnMapExitEvents() {
 	}
 }
 
+/**
+ * Rebuild the event lookup grid if the list of events was changed since the last check
+ */
+void MapRenderer::updateEventIndex() {
+	if (!event_index.needsUpdate(events))
+		return;
+
+	// the graphics of a tile can cover the mouse cursor while the tile itself is some distance away
+	const int tile_pixels = std::max(tset.max_size_x * TILE_W, tset.max_size_y * TILE_H);
+	const int tile_margin = static_cast<int>(ceilf(static_cast<float>(tile_pixels) * std::max(UNITS_PER_PIXEL_X, UNITS_PER_PIXEL_Y))) + 1;
+
+	event_index.build(events, w, h, tile_margin);
+}
+
 void MapRenderer::checkEvents(const FPoint& loc) {
 	Point maploc;
 	maploc.x = int(loc.x);
 	maploc.y = int(loc.y);
-	std::vector<Event>::iterator it;
 
-	// loop in reverse because we may erase elements
-	for (it = events.end(); it != events.begin(); ) {
-		--it;
+	updateEventIndex();
+	event_index.getLocationEvents(maploc, event_candidates);
+
+	// candidates are in descending order, so erasing an event doesn't move the ones we haven't checked yet
+	for (size_t i = 0; i < event_candidates.size(); ++i) {
+		std::vector<Event>::iterator it = events.begin() + event_candidates[i];
 
 		// skip inactive events
 		if (!EventManager::isActive(*it)) continue;
 
 		// static events are run every frame without interaction from the player
 		if ((*it).activate_type == EVENT_STATIC) {
-			if (EventManager::executeEvent(*it))
-				it = events.erase(it);
+			if (EventManager::executeEvent(*it)) {
+				events.erase(it);
+				event_index.invalidate();
+			}
 			continue;
 		}
 
 		if ((*it).activate_type == EVENT_ON_CLEAR) {
-			if (enemies_cleared && EventManager::executeEvent(*it))
-				it = events.erase(it);
+			if (enemies_cleared && EventManager::executeEvent(*it)) {
+				events.erase(it);
+				event_index.invalidate();
+			}
 			continue;
 		}
 
@@ -659,15 +789,19 @@ void MapRenderer::checkEvents(const FPoint& loc) {
 			else {
 				if ((*it).getComponent(EC_WAS_INSIDE_EVENT_AREA)) {
 					(*it).deleteAllComponents(EC_WAS_INSIDE_EVENT_AREA);
-					if (EventManager::executeEvent(*it))
-						it = events.erase(it);
+					if (EventManager::executeEvent(*it)) {
+						events.erase(it);
+						event_index.invalidate();
+					}
 				}
 			}
 		}
 		else {
 			if (inside)
-				if (EventManager::executeEvent(*it))
-					it = events.erase(it);
+				if (EventManager::executeEvent(*it)) {
+					events.erase(it);
+					event_index.invalidate();
+				}
 		}
 	}
 }
@@ -686,12 +820,15 @@ void MapRenderer::checkHotspots() {
 
 	show_tooltip = false;
 
-	std::vector<Event>::iterator it;
+	// only events with graphics that can reach the tile below the mouse cursor are checked
+	updateEventIndex();
+	event_index.getHotspotEvents(FPointToPoint(screen_to_map(inpt->mouse.x, inpt->mouse.y, shakycam.x, shakycam.y)), event_candidates);
 
-	// work backwards through events because events can be erased in the loop.
-	// this prevents the iterator from becoming invalid.
-	for (it = events.end(); it != events.begin(); ) {
-		--it;
+	size_t npc_cursor = pick_list.size();
+	const PickBounds* npc_pick = pick(inpt->mouse, PICK_NPC, npc_cursor);
+
+	for (size_t i = 0; i < event_candidates.size(); ++i) {
+		std::vector<Event>::iterator it = events.begin() + event_candidates[i];
 
 		for (int x=it->hotspot.x; x < it->hotspot.x + it->hotspot.w; ++x) {
 			for (int y=it->hotspot.y; y < it->hotspot.y + it->hotspot.h; ++y) {
@@ -702,19 +839,11 @@ void MapRenderer::checkHotspots() {
 				if (npc) {
 					is_npc = true;
 
-					Point p = map_to_screen(float(npc->x), float(npc->y), shakycam.x, shakycam.y);
-					p = centerTile(p);
-
-					Rect dest;
-					dest.x = p.x - npc->z;
-					dest.y = p.y - npc->a;
-					dest.w = npc->b;
-					dest.h = npc->c;
-
-					if (isWithinRect(dest, inpt->mouse)) {
+					// only the npc whose sprite is drawn on top can be clicked
+					if (npc_pick && static_cast<int>(npc_pick->map_pos.x) == npc->x && static_cast<int>(npc_pick->map_pos.y) == npc->y) {
 						matched = true;
-						tip_pos.x = dest.x + dest.w/2;
-						tip_pos.y = p.y - TOOLTIP_MARGIN_NPC;
+						tip_pos.x = npc_pick->bounds.x + npc_pick->bounds.w/2;
+						tip_pos.y = npc_pick->pos.y - TOOLTIP_MARGIN_NPC;
 					}
 				}
 				else {
@@ -768,8 +897,10 @@ void MapRenderer::checkHotspots() {
 						else if (inpt->lock[MAIN1]) return;
 
 						inpt->lock[MAIN1] = true;
-						if (EventManager::executeEvent(*it))
-							it = events.erase(it);
+						if (EventManager::executeEvent(*it)) {
+							events.erase(it);
+							event_index.invalidate();
+						}
 					}
 					return;
 				}
@@ -782,13 +913,15 @@ void MapRenderer::checkHotspots() {
 void MapRenderer::checkNearestEvent() {
 	if (!inpt->usingMouse()) show_tooltip = false;
 
-	std::vector<Event>::iterator it;
 	std::vector<Event>::iterator nearest = events.end();
 	float best_distance = std::numeric_limits<float>::max();
 
-	// loop in reverse because we may erase elements
-	for (it = events.end(); it != events.begin(); ) {
-		--it;
+	// only events with a center within interaction range of the hero are checked
+	updateEventIndex();
+	event_index.getEventsInRange(cam, INTERACT_RANGE, event_candidates);
+
+	for (size_t i = 0; i < event_candidates.size(); ++i) {
+		std::vector<Event>::iterator it = events.begin() + event_candidates[i];
 
 		// skip inactive events
 		if (!EventManager::isActive(*it)) continue;
@@ -824,8 +957,10 @@ void MapRenderer::checkNearestEvent() {
 		if (inpt->pressing[ACCEPT] && !inpt->lock[ACCEPT]) {
 			if (inpt->pressing[ACCEPT]) inpt->lock[ACCEPT] = true;
 
-			if(EventManager::executeEvent(*nearest))
+			if(EventManager::executeEvent(*nearest)) {
 				events.erase(nearest);
+				event_index.invalidate();
+			}
 		}
 	}
 }
@@ -41,6 +41,18 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 class FileParser;
 class WidgetTooltip;
 
+/**
+ * The screen area of a pickable sprite as it was drawn in the last frame
+ */
+class PickBounds {
+public:
+	Rect bounds;
+	Point pos; // the sprite's map_pos on the screen
+	FPoint map_pos;
+	uint8_t type;
+	size_t index; // see Renderable::pick_index, has to be checked against the list since it was drawn
+};
+
 class MapRenderer : public Map {
 private:
 
@@ -74,9 +86,18 @@ private:
 
 	void createTooltip(Event_Component *ec);
 
+	void updateEventIndex();
+	std::vector<size_t> event_candidates;
+
+	void setLights(std::vector<LightSource> &lights);
+	std::vector<RenderLight> render_lights;
+
 	FPoint shakycam;
 	TileSet tset;
 
+	// pickable sprites in the order they were drawn, so the last one is on top
+	std::vector<PickBounds> pick_list;
+
 public:
 	// functions
 	MapRenderer();
@@ -86,13 +107,16 @@ public:
 
 	int load(const std::string& filename);
 	void logic();
-	void render(std::vector<Renderable> &r, std::vector<Renderable> &r_dead);
+	void render(std::vector<Renderable> &r, std::vector<Renderable> &r_dead, std::vector<LightSource> &lights);
 
 	void checkEvents(const FPoint& loc);
 	void checkHotspots();
 	void checkNearestEvent();
 	void checkTooltip();
 
+	const PickBounds* pick(const Point& mouse, uint8_t type, size_t& cursor) const;
+	const std::vector<PickBounds>& getPickList() const;
+
 	// some events are automatically triggered when the map is loaded
 	void executeOnLoadEvents();
 
@@ -107,10 +131,15 @@ public:
 
 	// cam(x,y) is where on the map the camera is pointing
 	FPoint cam;
+	FPoint prev_cam; // cam at the start of the current logic frame
+
+	// how far rendering is between the previous and the current logic frame, from 0 to 1
+	float interpolation;
+	FPoint interpolate(const FPoint& prev, const FPoint& cur) const;
 
-	// indicates that the map was changed by an event, so the GameStatePlay
-	// will tell the mini map to update.
-	bool map_change;
+	// collision tiles that were changed by an event, so the GameStatePlay
+	// will tell the mini map to redraw them.
+	std::vector<Point> map_changes;
 
 	MapCollision collider;
 
@@ -216,12 +216,10 @@ MenuCharacter::MenuCharacter(StatBlock *_stats) {
 
 	base_stats.resize(PRIMARY_STATS.size());
 	base_stats_add.resize(PRIMARY_STATS.size());
-	base_bonus.resize(PRIMARY_STATS.size());
 
 	for (size_t i = 0; i < PRIMARY_STATS.size(); ++i) {
 		base_stats[i] = &stats->primary[i];
 		base_stats_add[i] = &stats->primary_additional[i];
-		base_bonus[i] = &stats->per_primary[i];
 	}
 }
 
@@ -335,7 +333,7 @@ void MenuCharacter::refreshStats() {
 		cstat[j].tip.addText(msg->get("base (%d), bonus (%d)", *(base_stats[j-2]), *(base_stats_add[j-2])));
 		bool have_bonus = false;
 		for (unsigned i=0; i<STAT_COUNT; ++i) {
-			if (base_bonus[j-2]->at(i) > 0) {
+			if (stats->def->per_primary[j-2][i] > 0) {
 				if (!have_bonus) {
 					cstat[j].tip.addText("\n" + msg->get("Related stats:"));
 					have_bonus = true;
@@ -362,12 +360,12 @@ Color MenuCharacter::bonusColor(int stat) {
 std::string MenuCharacter::statTooltip(int stat) {
 	std::string tooltip_text;
 
-	if (stats->per_level[stat] > 0)
-		tooltip_text += msg->get("Each level grants %d. ", stats->per_level[stat]);
+	if (stats->def->per_level[stat] > 0)
+		tooltip_text += msg->get("Each level grants %d. ", stats->def->per_level[stat]);
 
 	for (size_t i = 0; i < PRIMARY_STATS.size(); ++i) {
-		if (stats->per_primary[i][stat] > 0)
-			tooltip_text += msg->get("Each point of %s grants %d. ", stats->per_primary[i][stat], PRIMARY_STATS[i].name.c_str());
+		if (stats->def->per_primary[i][stat] > 0)
+			tooltip_text += msg->get("Each point of %s grants %d. ", stats->def->per_primary[i][stat], PRIMARY_STATS[i].name.c_str());
 	}
 
 	return tooltip_text;
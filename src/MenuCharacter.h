@@ -84,7 +84,6 @@ private:
 
 	std::vector<int*> base_stats;
 	std::vector<int*> base_stats_add;
-	std::vector< std::vector<int>* > base_bonus;
 
 public:
 	explicit MenuCharacter(StatBlock *stats);
@@ -22,6 +22,8 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include "EnemyManager.h"
 #include "FileParser.h"
 #include "MenuDevConsole.h"
+#include "MenuMiniMap.h"
+#include "SDLSoftwareBlitter.h"
 #include "SharedGameResources.h"
 #include "SharedResources.h"
 #include "Settings.h"
@@ -228,6 +230,8 @@ void MenuDevConsole::execute() {
 		log_history->add("list_status - " + msg->get("Prints out the active campaign statuses that match a search term. No search term will list all active statuses"), false);
 		log_history->add("list_items - " + msg->get("Prints a list of items that match a search term. No search term will list all items"), false);
 		log_history->add("exec - " + msg->get("parses a series of event components and executes them as a single event"), false);
+		log_history->add("benchmark_blit - " + msg->get("compares the software renderer's blitter against SDL_BlitSurface"), false);
+		log_history->add("benchmark_minimap - " + msg->get("compares drawing the minimap pixel by pixel against uploading it in one go"), false);
 		log_history->add("clear - " + msg->get("clears the command history"), false);
 		log_history->add("help - " + msg->get("displays this text"), false);
 	}
@@ -347,6 +351,22 @@ void MenuDevConsole::execute() {
 			log_history->add(msg->get("HINT: ") + args[0] + msg->get(" <key>=<val> <key>=<val> ..."), false, &color_hint);
 		}
 	}
+	else if (args[0] == "benchmark_blit") {
+		std::vector<std::string> results;
+		benchmarkBlitter(results);
+
+		for (size_t i = 0; i < results.size(); ++i) {
+			log_history->add(results[i], false);
+		}
+	}
+	else if (args[0] == "benchmark_minimap") {
+		std::vector<std::string> results;
+		benchmarkMiniMap(results);
+
+		for (size_t i = 0; i < results.size(); ++i) {
+			log_history->add(results[i], false);
+		}
+	}
 	else {
 		log_history->add(msg->get("ERROR: Unknown command"), false, &color_error);
 		log_history->add(msg->get("HINT: Type help"), false, &color_hint);
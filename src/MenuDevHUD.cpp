@@ -19,6 +19,7 @@ FLARE.  If not, see http://www.gnu.org/licenses/
  * class MenuDevHUD
  */
 
+#include "EnemyManager.h"
 #include "FileParser.h"
 #include "MenuDevHUD.h"
 #include "SharedGameResources.h"
@@ -68,9 +69,38 @@ void MenuDevHUD::align() {
 	mouse_pos.set(window_area.x, window_area.y+line_height*2, JUSTIFY_LEFT, VALIGN_TOP, ss.str(), font->getColor("menu_normal"));
 	line_width = std::max(line_width, mouse_pos.bounds.w);
 
+	const RenderStats& frame_stats = render_device->getFrameStats();
+	ss.str("");
+	ss << msg->get("Draws: ") << frame_stats.draws << msg->get(", Binds: ") << frame_stats.texture_binds;
+	ss << msg->get(", Programs: ") << frame_stats.program_switches << msg->get(", Uniforms: ") << frame_stats.uniform_writes;
+	ss << msg->get(", Skipped: ") << frame_stats.skipped;
+	render_stats.set(window_area.x, window_area.y+line_height*3, JUSTIFY_LEFT, VALIGN_TOP, ss.str(), font->getColor("menu_normal"));
+	line_width = std::max(line_width, render_stats.bounds.w);
+
+	const TextureMemory& texture_memory = render_device->getTextureMemory();
+	ss.str("");
+	ss << msg->get("Textures: ") << texture_memory.bytes / 1024 << msg->get(" KiB, Full size: ") << texture_memory.full_bytes / 1024 << msg->get(" KiB");
+	texture_stats.set(window_area.x, window_area.y+line_height*4, JUSTIFY_LEFT, VALIGN_TOP, ss.str(), font->getColor("menu_normal"));
+	line_width = std::max(line_width, texture_stats.bounds.w);
+
+	size_t enemy_bytes = 0;
+	size_t definition_bytes = 0;
+	size_t definition_count = 0;
+	size_t enemy_count = 0;
+	if (enemies) {
+		enemies->getMemoryUsage(enemy_bytes, definition_bytes, definition_count);
+		enemy_count = enemies->enemies.size();
+	}
+	const unsigned long bytes_per_enemy = static_cast<unsigned long>(enemy_count > 0 ? enemy_bytes / enemy_count : 0);
+	enemy_stats.set(window_area.x, window_area.y+line_height*5, JUSTIFY_LEFT, VALIGN_TOP, msg->get("Enemies: %d, Per enemy: %d B", static_cast<unsigned long>(enemy_count), bytes_per_enemy), font->getColor("menu_normal"));
+	line_width = std::max(line_width, enemy_stats.bounds.w);
+
+	definition_stats.set(window_area.x, window_area.y+line_height*6, JUSTIFY_LEFT, VALIGN_TOP, msg->get("Shared enemy data: %d KiB in %d types", static_cast<unsigned long>(definition_bytes / 1024), static_cast<unsigned long>(definition_count)), font->getColor("menu_normal"));
+	line_width = std::max(line_width, definition_stats.bounds.w);
+
 	window_area = original_area;
 	window_area.w = line_width;
-	window_area.h = line_height*3;
+	window_area.h = line_height*7;
 
 	Menu::align();
 }
@@ -89,6 +119,10 @@ void MenuDevHUD::render() {
 		player_pos.render();
 		mouse_pos.render();
 		target_pos.render();
+		render_stats.render();
+		texture_stats.render();
+		enemy_stats.render();
+		definition_stats.render();
 	}
 }
 
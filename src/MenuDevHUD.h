@@ -34,6 +34,10 @@ protected:
 	WidgetLabel player_pos;
 	WidgetLabel mouse_pos;
 	WidgetLabel target_pos;
+	WidgetLabel render_stats;
+	WidgetLabel texture_stats;
+	WidgetLabel enemy_stats;
+	WidgetLabel definition_stats;
 
 public:
 	MenuDevHUD();
@@ -33,12 +33,18 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include "UtilsParsing.h"
 
 #include <cmath>
+#include <iomanip>
 
 MenuMiniMap::MenuMiniMap()
 	: color_wall(128,128,128,255)
 	, color_obst(64,64,64,255)
 	, color_hero(255,255,255,255)
-	, map_surface(NULL) {
+	, map_surface(NULL)
+	, hero_marker(NULL)
+	, explore_radius(0)
+	, explore_pos(-1,-1)
+	, map_filename("")
+	, collider(NULL) {
 
 	createMapSurface();
 
@@ -58,6 +64,10 @@ MenuMiniMap::MenuMiniMap()
 			else if(infile.key == "text_pos") {
 				text_pos = eatLabelInfo(infile.val);
 			}
+			// @ATTR explore_radius|int|If greater than 0, only map tiles within this many tiles of the hero's path are shown. Explored areas are stored in the save file.
+			else if(infile.key == "explore_radius") {
+				explore_radius = std::max(0, toInt(infile.val));
+			}
 			else {
 				infile.error("MenuMiniMap: '%s' is not a valid key.", infile.key.c_str());
 			}
@@ -86,12 +96,30 @@ void MenuMiniMap::createMapSurface() {
 		delete map_surface;
 		map_surface = NULL;
 	}
+	if (hero_marker) {
+		delete hero_marker;
+		hero_marker = NULL;
+	}
 
 	Image *graphics;
 	graphics = render_device->createImage(512, 512);
 	if (graphics) {
 		map_surface = graphics->createSprite();
 		graphics->unref();
+
+		map_pixels.clear();
+		map_pixels.resize(map_surface->getGraphicsWidth() * map_surface->getGraphicsHeight(), Color(0,0,0,0));
+	}
+
+	// the hero is shown as a small cross in the center of the map
+	graphics = render_device->createImage(3, 3);
+	if (graphics) {
+		std::vector<Color> marker(9, Color(0,0,0,0));
+		marker[1] = marker[3] = marker[4] = marker[5] = marker[7] = color_hero;
+		graphics->writePixels(Rect(0, 0, 3, 3), marker);
+
+		hero_marker = graphics->createSprite();
+		graphics->unref();
 	}
 }
 
@@ -104,6 +132,9 @@ void MenuMiniMap::render(const FPoint& hero_pos) {
 	if (!text_pos.hidden) label->render();
 
 	if (map_surface) {
+		explore(hero_pos);
+		uploadPixels();
+
 		if (TILESET_ORIENTATION == TILESET_ISOMETRIC)
 			renderIso(hero_pos);
 		else // TILESET_ORTHOGONAL
@@ -111,17 +142,226 @@ void MenuMiniMap::render(const FPoint& hero_pos) {
 	}
 }
 
-void MenuMiniMap::prerender(MapCollision *collider, int map_w, int map_h) {
+/**
+ * Draw the whole map to the pixel buffer, which is then uploaded to the map surface in one go
+ */
+void MenuMiniMap::prerender(MapCollision *_collider, int map_w, int map_h, const std::string& _map_filename) {
 	if (!map_surface) return;
 
+	collider = _collider;
+	map_filename = _map_filename;
 	map_size.x = map_w;
 	map_size.y = map_h;
-	map_surface->getGraphics()->fillWithColor(Color(0,0,0,0));
+	explore_pos = Point(-1, -1);
+
+	map_pixels.assign(map_pixels.size(), Color(0,0,0,0));
+
+	for (int i=0; i<map_size.x; ++i) {
+		for (int j=0; j<map_size.y; ++j) {
+			drawTile(i, j);
+		}
+	}
+
+	dirty_area = Rect(0, 0, map_surface->getGraphicsWidth(), map_surface->getGraphicsHeight());
+}
+
+/**
+ * Redraw only the given tiles, used when events change the collision layer
+ */
+void MenuMiniMap::update(const std::vector<Point>& tiles) {
+	if (!map_surface || !collider) return;
+
+	for (size_t i=0; i<tiles.size(); ++i) {
+		drawTile(tiles[i].x, tiles[i].y);
+	}
+}
+
+/**
+ * Draw a single tile to the pixel buffer and mark its pixels as changed
+ */
+void MenuMiniMap::drawTile(int x, int y) {
+	if (!collider || x < 0 || y < 0 || x >= map_size.x || y >= map_size.y) return;
+	if (static_cast<size_t>(x) >= collider->colmap.size() || static_cast<size_t>(y) >= collider->colmap[x].size()) return;
+
+	const int surface_w = map_surface->getGraphicsWidth();
+	const int surface_h = map_surface->getGraphicsHeight();
+
+	// walls and low obstacles show as different colors
+	Color draw_color(0,0,0,0);
+	const int tile_type = collider->colmap[x][y];
+	if (tile_type == BLOCKS_ALL || tile_type == MAP_ONLY) draw_color = color_wall;
+	else if (tile_type == BLOCKS_MOVEMENT || tile_type == MAP_ONLY_ALT) draw_color = color_obst;
+
+	if (explore_radius > 0) {
+		std::vector<bool> *explored_tiles = getExploredTiles();
+		if (explored_tiles && !(*explored_tiles)[y * map_size.x + x])
+			draw_color = Color(0,0,0,0);
+	}
+
+	if (TILESET_ORIENTATION == TILESET_ISOMETRIC) {
+		// a 2x1 pixel area correlates to a tile
+		const int py = x + y;
+		const int px = x - y + (std::max(map_size.x, map_size.y)/2) * 2;
+		if (py < 0 || py >= surface_h) return;
+
+		for (int i = px-1; i <= px; ++i) {
+			if (i >= 0 && i < surface_w)
+				map_pixels[py * surface_w + i] = draw_color;
+		}
+		setDirty(Rect(px-1, py, 2, 1));
+	}
+	else { // TILESET_ORTHOGONAL
+		if (x >= surface_w || y >= surface_h) return;
+
+		map_pixels[y * surface_w + x] = draw_color;
+		setDirty(Rect(x, y, 1, 1));
+	}
+}
+
+void MenuMiniMap::setDirty(const Rect& area) {
+	if (dirty_area.w <= 0 || dirty_area.h <= 0) {
+		dirty_area = area;
+		return;
+	}
+
+	const int x2 = std::max(dirty_area.x + dirty_area.w, area.x + area.w);
+	const int y2 = std::max(dirty_area.y + dirty_area.h, area.y + area.h);
+	dirty_area.x = std::min(dirty_area.x, area.x);
+	dirty_area.y = std::min(dirty_area.y, area.y);
+	dirty_area.w = x2 - dirty_area.x;
+	dirty_area.h = y2 - dirty_area.y;
+}
+
+/**
+ * Copy the changed part of the pixel buffer to the map surface
+ */
+void MenuMiniMap::uploadPixels() {
+	if (dirty_area.w <= 0 || dirty_area.h <= 0) return;
+
+	const int surface_w = map_surface->getGraphicsWidth();
+	const int surface_h = map_surface->getGraphicsHeight();
+
+	Rect area;
+	area.x = std::max(dirty_area.x, 0);
+	area.y = std::max(dirty_area.y, 0);
+	area.w = std::min(dirty_area.x + dirty_area.w, surface_w) - area.x;
+	area.h = std::min(dirty_area.y + dirty_area.h, surface_h) - area.y;
+	dirty_area = Rect();
+
+	if (area.w <= 0 || area.h <= 0) return;
+
+	if (area.w == surface_w && area.h == surface_h) {
+		map_surface->getGraphics()->writePixels(area, map_pixels);
+		return;
+	}
+
+	upload_pixels.resize(area.w * area.h);
+	for (int j=0; j<area.h; ++j) {
+		std::vector<Color>::const_iterator row = map_pixels.begin() + ((area.y + j) * surface_w + area.x);
+		std::copy(row, row + area.w, upload_pixels.begin() + j * area.w);
+	}
+	map_surface->getGraphics()->writePixels(area, upload_pixels);
+}
+
+/**
+ * Returns the explored state of the current map, creating it if needed
+ */
+std::vector<bool>* MenuMiniMap::getExploredTiles() {
+	if (map_filename.empty() || map_size.x <= 0 || map_size.y <= 0) return NULL;
+
+	std::vector<bool> &tiles = explored[map_filename];
+	if (tiles.size() != static_cast<size_t>(map_size.x * map_size.y))
+		tiles.assign(map_size.x * map_size.y, false);
 
-	if (TILESET_ORIENTATION == TILESET_ISOMETRIC)
-		prerenderIso(collider);
-	else // TILESET_ORTHOGONAL
-		prerenderOrtho(collider);
+	return &tiles;
+}
+
+/**
+ * Mark the tiles around the hero as explored
+ * This is only done when the hero enters a new tile
+ */
+void MenuMiniMap::explore(const FPoint& hero_pos) {
+	if (explore_radius <= 0) return;
+
+	Point hero_tile = FPointToPoint(hero_pos);
+	if (hero_tile.x == explore_pos.x && hero_tile.y == explore_pos.y) return;
+	explore_pos = hero_tile;
+
+	std::vector<bool> *explored_tiles = getExploredTiles();
+	if (!explored_tiles) return;
+
+	const int radius_sq = explore_radius * explore_radius;
+	for (int i = std::max(0, hero_tile.x - explore_radius); i <= std::min(map_size.x - 1, hero_tile.x + explore_radius); ++i) {
+		for (int j = std::max(0, hero_tile.y - explore_radius); j <= std::min(map_size.y - 1, hero_tile.y + explore_radius); ++j) {
+			const int dx = i - hero_tile.x;
+			const int dy = j - hero_tile.y;
+			if (dx*dx + dy*dy > radius_sq) continue;
+
+			const size_t index = j * map_size.x + i;
+			if (!(*explored_tiles)[index]) {
+				(*explored_tiles)[index] = true;
+				drawTile(i, j);
+			}
+		}
+	}
+}
+
+void MenuMiniMap::clearExplored() {
+	explored.clear();
+	explore_pos = Point(-1, -1);
+}
+
+/**
+ * Explored areas are saved as the map filename, its tile count, and run lengths of
+ * alternating unexplored/explored tiles (starting with unexplored)
+ */
+void MenuMiniMap::getExplored(std::vector<std::string>& data) {
+	data.clear();
+
+	std::map<std::string, std::vector<bool> >::iterator it;
+	for (it = explored.begin(); it != explored.end(); ++it) {
+		const std::vector<bool> &tiles = it->second;
+		if (tiles.empty()) continue;
+
+		std::stringstream ss;
+		ss << it->first << "," << tiles.size();
+
+		bool value = false;
+		size_t run = 0;
+		for (size_t i=0; i<tiles.size(); ++i) {
+			if (tiles[i] != value) {
+				ss << "," << run;
+				value = tiles[i];
+				run = 0;
+			}
+			run++;
+		}
+		ss << "," << run;
+
+		data.push_back(ss.str());
+	}
+}
+
+void MenuMiniMap::setExplored(const std::string& data) {
+	std::string val = data + ',';
+
+	std::string filename = popFirstString(val);
+	int tile_count = popFirstInt(val);
+	if (filename.empty() || tile_count <= 0) return;
+
+	std::vector<bool> &tiles = explored[filename];
+	tiles.assign(tile_count, false);
+
+	bool value = false;
+	size_t index = 0;
+	std::string run;
+	while ((run = popFirstString(val)) != "") {
+		int count = toInt(run);
+		for (int i=0; i<count && index < tiles.size(); ++i) {
+			tiles[index++] = value;
+		}
+		value = !value;
+	}
 }
 
 /**
@@ -150,12 +390,7 @@ void MenuMiniMap::renderOrtho(const FPoint& hero_pos) {
 		render_device->render(map_surface);
 	}
 
-	render_device->drawPixel(window_area.x + pos.x + pos.w/2, window_area.y + pos.y + pos.h/2, color_hero);
-	render_device->drawPixel(window_area.x + pos.x + pos.w/2 + 1, window_area.y + pos.y + pos.h/2, color_hero);
-	render_device->drawPixel(window_area.x + pos.x + pos.w/2 - 1, window_area.y + pos.y + pos.h/2, color_hero);
-	render_device->drawPixel(window_area.x + pos.x + pos.w/2, window_area.y + pos.y + pos.h/2 + 1, color_hero);
-	render_device->drawPixel(window_area.x + pos.x + pos.w/2, window_area.y + pos.y + pos.h/2 - 1, color_hero);
-
+	renderHeroMarker();
 }
 
 /**
@@ -186,88 +421,83 @@ void MenuMiniMap::renderIso(const FPoint& hero_pos) {
 		render_device->render(map_surface);
 	}
 
-	render_device->drawPixel(window_area.x + pos.x + pos.w/2 + 1, window_area.y + pos.y + pos.h/2, color_hero);
-	render_device->drawPixel(window_area.x + pos.x + pos.w/2 - 1, window_area.y + pos.y + pos.h/2, color_hero);
-	render_device->drawPixel(window_area.x + pos.x + pos.w/2, window_area.y + pos.y + pos.h/2 + 1, color_hero);
-	render_device->drawPixel(window_area.x + pos.x + pos.w/2, window_area.y + pos.y + pos.h/2 - 1, color_hero);
-	render_device->drawPixel(window_area.x + pos.x + pos.w/2, window_area.y + pos.y + pos.h/2, color_hero);
+	renderHeroMarker();
 }
 
-void MenuMiniMap::prerenderOrtho(MapCollision *collider) {
-	for (int i=0; i<std::min(map_surface->getGraphicsWidth(), map_size.x); i++) {
-		for (int j=0; j<std::min(map_surface->getGraphicsHeight(), map_size.y); j++) {
-			if (collider->colmap[i][j] == 1 || collider->colmap[i][j] == 5) {
-				map_surface->getGraphics()->drawPixel(i, j, color_wall);
-			}
-			else if (collider->colmap[i][j] == 2 || collider->colmap[i][j] == 6) {
-				map_surface->getGraphics()->drawPixel(i, j, color_obst);
-			}
-		}
-	}
-}
-
-void MenuMiniMap::prerenderIso(MapCollision *collider) {
-	// a 2x1 pixel area correlates to a tile, so we can traverse tiles using pixel counting
-	Color draw_color;
-	int tile_type;
-
-	Point tile_cursor;
-	tile_cursor.x = -std::max(map_size.x, map_size.y)/2;
-	tile_cursor.y = std::max(map_size.x, map_size.y)/2;
-
-	bool odd_row = false;
-
-	// for each pixel row
-	for (int j=0; j<map_surface->getGraphicsHeight(); j++) {
+void MenuMiniMap::renderHeroMarker() {
+	if (!hero_marker) return;
 
-		// for each 2-px wide column
-		for (int i=0; i<map_surface->getGraphicsWidth(); i+=2) {
+	hero_marker->setDest(window_area.x + pos.x + pos.w/2 - 1, window_area.y + pos.y + pos.h/2 - 1);
+	render_device->render(hero_marker);
+}
 
-			// if this tile is the max map size
-			if (tile_cursor.x >= 0 && tile_cursor.y >= 0 && tile_cursor.x < map_size.x && tile_cursor.y < map_size.y) {
+MenuMiniMap::~MenuMiniMap() {
+	if (map_surface)
+		delete map_surface;
+	if (hero_marker)
+		delete hero_marker;
 
-				tile_type = collider->colmap[tile_cursor.x][tile_cursor.y];
-				bool draw_tile = true;
+	delete label;
+}
 
-				// walls and low obstacles show as different colors
-				if (tile_type == 1 || tile_type == 5) draw_color = color_wall;
-				else if (tile_type == 2 || tile_type == 6) draw_color = color_obst;
-				else draw_tile = false;
+/**
+ * Time the creation of the minimap surface of a 256x256 isometric map on the active
+ * render device, drawn pixel by pixel as before, and uploaded from a buffer as now
+ * Every tile is drawn, so this is the worst case for the pixel by pixel version.
+ */
+void benchmarkMiniMap(std::vector<std::string>& results) {
+	const int MAP_SIZE = 256;
+	const int SURFACE_SIZE = 512;
+	const int ITERATIONS = 4;
+
+	Image* graphics = render_device->createImage(SURFACE_SIZE, SURFACE_SIZE);
+	if (!graphics) {
+		results.push_back("Unable to create the benchmark image");
+		return;
+	}
 
-				if (draw_tile) {
-					if (odd_row) {
-						map_surface->getGraphics()->drawPixel(i, j, draw_color);
-						map_surface->getGraphics()->drawPixel(i+1, j, draw_color);
-					}
-					else {
-						map_surface->getGraphics()->drawPixel(i-1, j, draw_color);
-						map_surface->getGraphics()->drawPixel(i, j, draw_color);
-					}
-				}
+	const Color color_wall(128,128,128,255);
+	const Color color_obst(64,64,64,255);
+	const double freq = static_cast<double>(SDL_GetPerformanceFrequency());
+
+	Uint64 start = SDL_GetPerformanceCounter();
+	for (int n = 0; n < ITERATIONS; ++n) {
+		for (int x = 0; x < MAP_SIZE; ++x) {
+			for (int y = 0; y < MAP_SIZE; ++y) {
+				const int py = x + y;
+				const int px = x - y + MAP_SIZE;
+				const Color& draw_color = ((x + y) % 2 == 0 ? color_wall : color_obst);
+				graphics->drawPixel(px-1, py, draw_color);
+				graphics->drawPixel(px, py, draw_color);
 			}
-
-			// moving screen-right in isometric is +x -y in map coordinates
-			tile_cursor.x++;
-			tile_cursor.y--;
 		}
-
-		// return tile cursor to next row of tiles
-		if (odd_row) {
-			odd_row = false;
-			tile_cursor.x -= map_surface->getGraphicsWidth()/2;
-			tile_cursor.y += (map_surface->getGraphicsWidth()/2 +1);
-		}
-		else {
-			odd_row = true;
-			tile_cursor.x -= (map_surface->getGraphicsWidth()/2 -1);
-			tile_cursor.y += map_surface->getGraphicsWidth()/2;
+	}
+	double pixel_time = static_cast<double>(SDL_GetPerformanceCounter() - start) / freq;
+
+	std::vector<Color> pixels;
+	start = SDL_GetPerformanceCounter();
+	for (int n = 0; n < ITERATIONS; ++n) {
+		pixels.assign(SURFACE_SIZE * SURFACE_SIZE, Color(0,0,0,0));
+		for (int x = 0; x < MAP_SIZE; ++x) {
+			for (int y = 0; y < MAP_SIZE; ++y) {
+				const int py = x + y;
+				const int px = x - y + MAP_SIZE;
+				const Color& draw_color = ((x + y) % 2 == 0 ? color_wall : color_obst);
+				pixels[py * SURFACE_SIZE + px - 1] = draw_color;
+				pixels[py * SURFACE_SIZE + px] = draw_color;
+			}
 		}
+		graphics->writePixels(Rect(0, 0, SURFACE_SIZE, SURFACE_SIZE), pixels);
 	}
-}
+	double buffer_time = static_cast<double>(SDL_GetPerformanceCounter() - start) / freq;
 
-MenuMiniMap::~MenuMiniMap() {
-	if (map_surface)
-		delete map_surface;
+	graphics->unref();
 
-	delete label;
+	std::stringstream ss;
+	ss << std::fixed << std::setprecision(2);
+	ss << "minimap " << MAP_SIZE << "x" << MAP_SIZE << ": drawPixel " << (pixel_time * 1000.0 / ITERATIONS) << "ms, ";
+	ss << "writePixels " << (buffer_time * 1000.0 / ITERATIONS) << "ms";
+	if (buffer_time > 0)
+		ss << " (x" << (pixel_time / buffer_time) << ")";
+	results.push_back(ss.str());
 }
@@ -38,8 +38,21 @@ private:
 	Color color_hero;
 
 	Sprite *map_surface;
+	Sprite *hero_marker;
 	Point map_size;
 
+	// a copy of the pixels in map_surface; changes are uploaded once per frame
+	std::vector<Color> map_pixels;
+	std::vector<Color> upload_pixels;
+	Rect dirty_area;
+
+	// tiles further than this from the hero are hidden until they have been explored. 0 shows the whole map
+	int explore_radius;
+	Point explore_pos;
+	std::string map_filename;
+	std::map<std::string, std::vector<bool> > explored;
+	MapCollision *collider;
+
 	Rect pos;
 	LabelInfo text_pos;
 	WidgetLabel *label;
@@ -47,8 +60,12 @@ private:
 	void createMapSurface();
 	void renderIso(const FPoint& hero_pos);
 	void renderOrtho(const FPoint& hero_pos);
-	void prerenderOrtho(MapCollision *collider);
-	void prerenderIso(MapCollision *collider);
+	void renderHeroMarker();
+	void drawTile(int x, int y);
+	void setDirty(const Rect& area);
+	void uploadPixels();
+	void explore(const FPoint& hero_pos);
+	std::vector<bool>* getExploredTiles();
 
 public:
 	MenuMiniMap();
@@ -57,9 +74,15 @@ public:
 
 	void render();
 	void render(const FPoint& hero_pos);
-	void prerender(MapCollision *collider, int map_w, int map_h);
+	void prerender(MapCollision *_collider, int map_w, int map_h, const std::string& _map_filename);
+	void update(const std::vector<Point>& tiles);
 	void setMapTitle(const std::string& map_title);
+
+	void clearExplored();
+	void getExplored(std::vector<std::string>& data);
+	void setExplored(const std::string& data);
 };
 
+void benchmarkMiniMap(std::vector<std::string>& results);
 
 #endif
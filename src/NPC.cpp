@@ -297,6 +297,9 @@ int NPC::loadSound(const std::string& fname, int type) {
 }
 
 void NPC::logic() {
+	// npcs keep their map position in pos instead of stats.pos
+	prev_pos = pos;
+
 	activeAnimation->advanceFrame();
 }
 
@@ -522,12 +525,9 @@ void NPC::processEvent(unsigned int dialog_node, unsigned int cursor) {
 	EventManager::executeEvent(ev);
 }
 
-Renderable NPC::getRender() {
-	Renderable r = activeAnimation->getCurrentFrame(direction);
-	r.map_pos.x = pos.x;
-	r.map_pos.y = pos.y;
-
-	return r;
+void NPC::getRender(Renderable& r) {
+	activeAnimation->getCurrentFrame(direction, r);
+	r.map_pos = mapr->interpolate(prev_pos, pos);
 }
 
 bool NPC::isDialogType(const EVENT_COMPONENT_TYPE &type) {
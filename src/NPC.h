@@ -56,7 +56,7 @@ public:
 	bool checkVendor();
 	bool processDialog(unsigned int dialog_node, unsigned int& event_cursor);
 	void processEvent(unsigned int dialog_node, unsigned int cursor);
-	virtual Renderable getRender();
+	virtual void getRender(Renderable& r);
 
 	// general info
 	std::string name;
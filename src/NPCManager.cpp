@@ -43,7 +43,11 @@ NPCManager::NPCManager(StatBlock *_stats)
 
 void NPCManager::addRenders(std::vector<Renderable> &r) {
 	for (unsigned i=0; i<npcs.size(); i++) {
-		r.push_back(npcs[i]->getRender());
+		r.resize(r.size()+1);
+		Renderable& re = r.back();
+		npcs[i]->getRender(re);
+		re.pick_type = PICK_NPC;
+		re.pick_index = i;
 	}
 }
 
@@ -79,6 +83,7 @@ void NPCManager::handleNewMap() {
 		npc->load(mn.id);
 		npc->pos.x = mn.pos.x;
 		npc->pos.y = mn.pos.y;
+		npc->prev_pos = npc->pos;
 
 		// npc->stock.sort();
 		npcs.push_back(npc);
@@ -122,6 +127,8 @@ void NPCManager::handleNewMap() {
 		mapr->events.push_back(ev);
 	}
 
+	mapr->event_index.invalidate();
+
 }
 
 void NPCManager::logic() {
@@ -33,6 +33,207 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #define glActiveTexture glWinActiveTexture
 #endif
 
+OpenGLState gl_state;
+
+OpenGLState::OpenGLState() {
+	reset();
+}
+
+/**
+ * Sets the shadow copy to the state of a newly created context
+ */
+void OpenGLState::reset() {
+	active_unit = 0;
+	for (int i = 0; i < TEXTURE_UNITS; ++i) {
+		textures[i] = 0;
+	}
+	array_buffer = 0;
+	element_buffer = 0;
+	program = 0;
+	attrib_enabled = -1;
+	attrib_location = -1;
+	attrib_buffer = 0;
+	uniforms.clear();
+}
+
+void OpenGLState::bindTexture(GLuint unit, GLuint texture) {
+	if (unit >= static_cast<GLuint>(TEXTURE_UNITS)) return;
+
+	// texture edits after this call go to the active unit, even if the bind is skipped
+	if (active_unit != unit) {
+		glActiveTexture(GL_TEXTURE0 + unit);
+		active_unit = unit;
+	}
+
+	if (textures[unit] == texture) {
+		stats.skipped++;
+		return;
+	}
+
+	glBindTexture(GL_TEXTURE_2D, texture);
+	textures[unit] = texture;
+	stats.texture_binds++;
+}
+
+void OpenGLState::bindBuffer(GLenum target, GLuint buffer) {
+	GLuint* bound = (target == GL_ELEMENT_ARRAY_BUFFER ? &element_buffer : &array_buffer);
+
+	if (*bound == buffer) {
+		stats.skipped++;
+		return;
+	}
+
+	glBindBuffer(target, buffer);
+	*bound = buffer;
+}
+
+void OpenGLState::useProgram(GLuint _program) {
+	if (program == _program) {
+		stats.skipped++;
+		return;
+	}
+
+	glUseProgram(_program);
+	program = _program;
+	stats.program_switches++;
+}
+
+/**
+ * Uniform values are part of the program object, so they are cached per program
+ */
+OpenGLState::ProgramUniforms* OpenGLState::getUniforms(GLint location) {
+	if (location < 0) return NULL;
+
+	ProgramUniforms* u = NULL;
+	for (size_t i = 0; i < uniforms.size(); ++i) {
+		if (uniforms[i].program == program) {
+			u = &uniforms[i];
+			break;
+		}
+	}
+	if (!u) {
+		uniforms.resize(uniforms.size()+1);
+		u = &uniforms.back();
+		u->program = program;
+	}
+
+	if (u->is_set.size() <= static_cast<size_t>(location)) {
+		u->is_set.resize(location+1, false);
+		u->ints.resize(location+1, 0);
+		u->floats.resize((location+1)*4, 0);
+	}
+
+	return u;
+}
+
+void OpenGLState::uniform1i(GLint location, GLint value) {
+	ProgramUniforms* u = getUniforms(location);
+	if (!u) return;
+
+	if (u->is_set[location] && u->ints[location] == value) {
+		stats.skipped++;
+		return;
+	}
+
+	glUniform1i(location, value);
+	u->is_set[location] = true;
+	u->ints[location] = value;
+	stats.uniform_writes++;
+}
+
+void OpenGLState::uniform4fv(GLint location, const GLfloat* value) {
+	ProgramUniforms* u = getUniforms(location);
+	if (!u) return;
+
+	GLfloat* cached = &u->floats[location*4];
+	if (u->is_set[location] && memcmp(cached, value, sizeof(GLfloat)*4) == 0) {
+		stats.skipped++;
+		return;
+	}
+
+	glUniform4fv(location, 1, value);
+	u->is_set[location] = true;
+	memcpy(cached, value, sizeof(GLfloat)*4);
+	stats.uniform_writes++;
+}
+
+/**
+ * Make the given attribute the only enabled one and point it at the bound array buffer (2 floats per vertex)
+ */
+void OpenGLState::setPositionAttribute(GLint location) {
+	if (location < 0) return;
+
+	if (attrib_enabled != location) {
+		if (attrib_enabled >= 0)
+			glDisableVertexAttribArray(attrib_enabled);
+		glEnableVertexAttribArray(location);
+		attrib_enabled = location;
+	}
+
+	if (attrib_location == location && attrib_buffer == array_buffer) {
+		stats.skipped++;
+		return;
+	}
+
+	glVertexAttribPointer(
+		location,
+		2, GL_FLOAT, GL_FALSE,
+		sizeof(GLfloat)*2, (void*)0
+	);
+	attrib_location = location;
+	attrib_buffer = array_buffer;
+}
+
+void OpenGLState::drawElements(GLenum mode, GLsizei count) {
+	glDrawElements(
+		mode,               /* mode */
+		count,              /* count */
+		GL_UNSIGNED_SHORT,  /* type */
+		(void*)0            /* element array buffer offset */
+	);
+	stats.draws++;
+}
+
+/**
+ * Deleted objects are unbound by GL, and their names can be reused by new objects
+ */
+void OpenGLState::deleteTexture(GLuint texture) {
+	glDeleteTextures(1, &texture);
+
+	for (int i = 0; i < TEXTURE_UNITS; ++i) {
+		if (textures[i] == texture)
+			textures[i] = 0;
+	}
+}
+
+void OpenGLState::deleteBuffer(GLuint buffer) {
+	glDeleteBuffers(1, &buffer);
+
+	if (array_buffer == buffer)
+		array_buffer = 0;
+	if (element_buffer == buffer)
+		element_buffer = 0;
+	if (attrib_buffer == buffer) {
+		attrib_location = -1;
+		attrib_buffer = 0;
+	}
+}
+
+void OpenGLState::deleteProgram(GLuint _program) {
+	glDeleteProgram(_program);
+
+	// a program that is in use is only deleted once it's no longer used
+	if (program == _program)
+		program = 0;
+
+	for (size_t i = 0; i < uniforms.size(); ++i) {
+		if (uniforms[i].program == _program) {
+			uniforms.erase(uniforms.begin()+i);
+			break;
+		}
+	}
+}
+
 /**
  * These will be used for both drawing on screen and image
  */
@@ -94,7 +295,7 @@ void drawPrimitive(GLfloat* vertexData, const Color& color, DRAW_TYPE type)
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 	glEnable(GL_BLEND);
 
-	glUseProgram(g_program);
+	gl_state.useProgram(g_program);
 
 	GLfloat _color[4];
 	_color[0] = static_cast<float>(color.r) / 255.0f;
@@ -102,29 +303,61 @@ void drawPrimitive(GLfloat* vertexData, const Color& color, DRAW_TYPE type)
 	_color[2] = static_cast<float>(color.b) / 255.0f;
 	_color[3] = static_cast<float>(color.a) / 255.0f;
 
-	glUniform4fv(g_color, 1, _color);
+	gl_state.uniform4fv(g_color, _color);
 
-	glBindBuffer(GL_ARRAY_BUFFER, g_vertex_buffer);
-	glVertexAttribPointer(
-		g_position,
-		2, GL_FLOAT, GL_FALSE,
-		sizeof(GLfloat)*2, (void*)0
-	);
+	gl_state.bindBuffer(GL_ARRAY_BUFFER, g_vertex_buffer);
+	gl_state.setPositionAttribute(g_position);
 
-	glEnableVertexAttribArray(g_position);
+	gl_state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, g_element_buffer);
+	gl_state.drawElements(mode, points_count);
 
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g_element_buffer);
-	glDrawElements(
-		mode,               /* mode */
-		points_count,       /* count */
-		GL_UNSIGNED_SHORT,  /* type */
-		(void*)0            /* element array buffer offset */
-	);
+	gl_state.deleteBuffer(g_vertex_buffer);
+	gl_state.deleteBuffer(g_element_buffer);
+}
+
+// smaller images, mostly menu graphics, are kept at full resolution so that the interface stays sharp
+const int TEXTURE_HALF_SIZE_MIN_AREA = 256 * 256;
+
+/**
+ * Scale an 8-bit channel to the range 0 - max, rounded to nearest
+ */
+static inline unsigned quantize(Uint8 c, unsigned max) {
+	return (c * max + 127) / 255;
+}
+
+/**
+ * Downscale 32-bit RGBA pixels by 2 in both directions
+ * Colors are weighted by alpha, so that transparent pixels don't darken the edges of sprites.
+ */
+static void halveTexture(const Uint8* pixels, int pitch, int width, int height, std::vector<Uint8>& out) {
+	const int half_w = width / 2;
+	const int half_h = height / 2;
+	out.assign(half_w * half_h * 4, 0);
+
+	for (int y = 0; y < half_h; ++y) {
+		const Uint8* row0 = pixels + (y * 2) * pitch;
+		const Uint8* row1 = row0 + pitch;
+		for (int x = 0; x < half_w; ++x) {
+			const Uint8* p[4] = {row0 + x * 8, row0 + x * 8 + 4, row1 + x * 8, row1 + x * 8 + 4};
+
+			unsigned sum_a = 0;
+			unsigned sum_c[3] = {0, 0, 0};
+			for (int i = 0; i < 4; ++i) {
+				sum_a += p[i][3];
+				for (int c = 0; c < 3; ++c) {
+					sum_c[c] += p[i][c] * p[i][3];
+				}
+			}
 
-	glDisableVertexAttribArray(g_position);
+			if (sum_a == 0) continue;
 
-	glDeleteBuffers(1, &g_vertex_buffer);
-	glDeleteBuffers(1, &g_element_buffer);
+			Uint8* dest = &out[(y * half_w + x) * 4];
+			for (int c = 0; c < 3; ++c) {
+				dest[c] = static_cast<Uint8>((sum_c[c] + sum_a / 2) / sum_a);
+			}
+			dest[3] = static_cast<Uint8>((sum_a + 2) / 4);
+		}
+	}
 }
 
 OpenGLImage::OpenGLImage(RenderDevice *_device)
@@ -132,29 +365,32 @@ OpenGLImage::OpenGLImage(RenderDevice *_device)
 	, texture(-1)
 	, normalTexture(-1)
 	, w(0)
-	, h(0) {
+	, h(0)
+	, reduced(false)
+	, texture_bytes(0)
+	, texture_full_bytes(0) {
 }
 
 OpenGLImage::~OpenGLImage() {
+	setTextureMemory(0, 0);
+
 	if ((int)texture != -1)
-		glDeleteTextures(1, &texture);
+		gl_state.deleteTexture(texture);
 
 	if ((int)normalTexture != -1)
-		glDeleteTextures(1, &normalTexture);
+		gl_state.deleteTexture(normalTexture);
 }
 
 int OpenGLImage::getWidth() const {
-	glBindTexture(GL_TEXTURE_2D, texture);
 	return w;
 }
 
 int OpenGLImage::getHeight() const {
-	glBindTexture(GL_TEXTURE_2D, texture);
 	return h;
 }
 
 void OpenGLImage::fillWithColor(const Color& color) {
-	if ((int)texture == -1) return;
+	if ((int)texture == -1 || reduced) return;
 
 	int channels = 4;
 	int bytes = getWidth() * getHeight() * channels;
@@ -169,7 +405,7 @@ void OpenGLImage::fillWithColor(const Color& color) {
 		buffer[i + 3] = static_cast<unsigned char>(color.a);
 	}
 
-	glBindTexture(GL_TEXTURE_2D, texture);
+	gl_state.bindTexture(0, texture);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, getWidth(), getHeight(), 0, GL_RGBA, GL_UNSIGNED_BYTE, buffer);
 	int error = glGetError();
 	if (error != GL_NO_ERROR)
@@ -182,18 +418,31 @@ void OpenGLImage::fillWithColor(const Color& color) {
  * Set the pixel at (x, y) to the given value
  */
 void OpenGLImage::drawPixel(int x, int y, const Color& color) {
-	GLuint frameBuffer;
-	GLint view[4];
-	glGetIntegerv(GL_VIEWPORT, view);
-	configureFrameBuffer(&frameBuffer, this->texture, w, h);
-
-	GLfloat positionData[2];
-	positionData[0] = 2.0f * static_cast<float>(x)/static_cast<float>(w) - 1.0f;
-	positionData[1] = 2.0f * static_cast<float>(y)/static_cast<float>(h) - 1.0f;
+	// a sub-texture upload is much cheaper than setting up a frame buffer for a single pixel
+	writePixels(Rect(x, y, 1, 1), std::vector<Color>(1, color));
+}
 
-	drawPrimitive(positionData, color, TYPE_PIXEL);
+/*
+ * Copy a block of pixels (row by row, area.w * area.h) to the image with a single texture upload
+ */
+void OpenGLImage::writePixels(const Rect& area, const std::vector<Color>& pixels) {
+	if ((int)texture == -1 || reduced || area.w <= 0 || area.h <= 0) return;
+	if (pixels.size() < static_cast<size_t>(area.w * area.h)) return;
+	if (area.x < 0 || area.y < 0 || area.x + area.w > w || area.y + area.h > h) return;
+
+	std::vector<unsigned char> buffer(area.w * area.h * 4);
+	for (size_t i = 0; i < pixels.size() && i * 4 < buffer.size(); ++i) {
+		buffer[i * 4] = static_cast<unsigned char>(pixels[i].r);
+		buffer[i * 4 + 1] = static_cast<unsigned char>(pixels[i].g);
+		buffer[i * 4 + 2] = static_cast<unsigned char>(pixels[i].b);
+		buffer[i * 4 + 3] = static_cast<unsigned char>(pixels[i].a);
+	}
 
-	disableFrameBuffer(&frameBuffer, view);
+	gl_state.bindTexture(0, texture);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, area.x, area.y, area.w, area.h, GL_RGBA, GL_UNSIGNED_BYTE, &buffer[0]);
+	int error = glGetError();
+	if (error != GL_NO_ERROR)
+		logInfo("Error while calling glTexSubImage2D(): %d", error);
 }
 
 /**
@@ -207,11 +456,30 @@ Image* OpenGLImage::resize(int width, int height) {
 	return this;
 }
 
+/**
+ * Update the texture memory that the render device counts for this image
+ */
+void OpenGLImage::setTextureMemory(unsigned long bytes, unsigned long full_bytes) {
+	OpenGLRenderDevice* gl_device = static_cast<OpenGLRenderDevice*>(device);
+	gl_device->removeTextureMemory(texture_bytes, texture_full_bytes);
+	gl_device->addTextureMemory(bytes, full_bytes);
+
+	texture_bytes = bytes;
+	texture_full_bytes = full_bytes;
+}
+
 OpenGLRenderDevice::OpenGLRenderDevice()
 	: window(NULL)
 	, renderer(NULL)
 	, titlebar_icon(NULL)
 	, title(NULL)
+	, m_light_vertex_shader(0)
+	, m_light_fragment_shader(0)
+	, m_light_program(0)
+	, m_lightmap(0)
+	, m_lightmap_framebuffer(0)
+	, lightmap_size()
+	, lightmap_active(false)
 {
 #ifdef __ANDROID__
 	//SDL_LogSetAllPriority(SDL_LOG_PRIORITY_VERBOSE);
@@ -294,6 +562,8 @@ int OpenGLRenderDevice::createContext(bool allow_fallback) {
 		if (window) {
 			renderer = SDL_GL_CreateContext(window);
 			if (renderer) {
+				gl_state.reset();
+
 				if (TEXTURE_FILTER && !IGNORE_TEXTURE_FILTER)
 					SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "1");
 				else
@@ -413,17 +683,15 @@ int OpenGLRenderDevice::render(Renderable& r, Rect& dest) {
 	if (texture == 0)
 		return 1;
 
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, texture);
+	gl_state.bindTexture(0, texture);
 
 	bool normals = ((int)normalTexture != -1);
 	if (normals)
 	{
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, normalTexture);
+		gl_state.bindTexture(1, normalTexture);
 	}
 
-	composeFrame(m_offset, m_texelOffset, normals);
+	composeFrame(m_offset, m_texelOffset, normals, lightmap_active);
 
 	return 0;
 }
@@ -506,7 +774,7 @@ GLuint createBuffer(GLenum target, const void *buffer_data, GLsizei buffer_size)
 {
 	GLuint buffer;
 	glGenBuffers(1, &buffer);
-	glBindBuffer(target, buffer);
+	gl_state.bindBuffer(target, buffer);
 	glBufferData(target, buffer_size, buffer_data, GL_STATIC_DRAW);
 	return buffer;
 }
@@ -540,14 +808,146 @@ int OpenGLRenderDevice::buildResources()
 	uniforms.screenWidth = glGetUniformLocation(m_program, "screenWidth");
 	uniforms.screenHeight = glGetUniformLocation(m_program, "screenHeight");
 
+	uniforms.lightmap = glGetUniformLocation(m_program, "lightmap");
+	uniforms.lightmapEnabled = glGetUniformLocation(m_program, "lightmapEnabled");
+
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 	glEnable(GL_BLEND);
 
 	preparePrimitiveProgram();
 
+	// lighting is optional, the game is drawn fully lit without it
+	if (buildLightResources() != 0)
+		m_light_program = 0;
+
+	return 0;
+}
+
+int OpenGLRenderDevice::buildLightResources()
+{
+	m_light_vertex_shader = getShader(GL_VERTEX_SHADER, "shaders/vertex_l.glsl");
+	if (m_light_vertex_shader == 0)
+		return 1;
+
+	m_light_fragment_shader = getShader(GL_FRAGMENT_SHADER, "shaders/fragment_l.glsl");
+	if (m_light_fragment_shader == 0)
+		return 1;
+
+	m_light_program = createProgram(m_light_vertex_shader, m_light_fragment_shader);
+	if (m_light_program == 0)
+		return 1;
+
+	light_shader.position = glGetAttribLocation(m_light_program, "position");
+	light_shader.rect = glGetUniformLocation(m_light_program, "lightRect");
+	light_shader.color = glGetUniformLocation(m_light_program, "lightColor");
+
 	return 0;
 }
 
+/**
+ * (Re)create the light map texture and the frame buffer used to draw to it
+ */
+bool OpenGLRenderDevice::createLightmap(const Point& size)
+{
+	if (m_lightmap != 0)
+		gl_state.deleteTexture(m_lightmap);
+
+	glGenTextures(1, &m_lightmap);
+	gl_state.bindTexture(0, m_lightmap);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,     GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,     GL_CLAMP_TO_EDGE);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+	if (m_lightmap_framebuffer == 0)
+		glGenFramebuffers(1, &m_lightmap_framebuffer);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_lightmap_framebuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_lightmap, 0);
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	if (status != GL_FRAMEBUFFER_COMPLETE) {
+		logError("OpenGLRenderDevice: Failed to create the light map: %d. Lighting is disabled.", status);
+		return false;
+	}
+
+	lightmap_size = size;
+	return true;
+}
+
+/**
+ * Draw the lights to the light map, on top of the ambient color.
+ * Everything drawn with render() until clearLights() is multiplied with the light map.
+ */
+void OpenGLRenderDevice::setLights(const Color& ambient, const std::vector<RenderLight>& lights)
+{
+	if (m_light_program == 0)
+		return;
+
+	const float scale = std::min(std::max(LIGHTMAP_SCALE, 0.1f), 1.0f);
+	Point size;
+	size.x = std::max(static_cast<int>(static_cast<float>(VIEW_W) * scale), 1);
+	size.y = std::max(static_cast<int>(static_cast<float>(VIEW_H) * scale), 1);
+
+	if (m_lightmap == 0 || size.x != lightmap_size.x || size.y != lightmap_size.y) {
+		if (!createLightmap(size)) {
+			gl_state.deleteProgram(m_light_program);
+			m_light_program = 0;
+			return;
+		}
+	}
+
+	GLint view[4];
+	glGetIntegerv(GL_VIEWPORT, view);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_lightmap_framebuffer);
+	glViewport(0, 0, size.x, size.y);
+
+	glClearColor(static_cast<float>(ambient.r) / 255.0f, static_cast<float>(ambient.g) / 255.0f, static_cast<float>(ambient.b) / 255.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	// lights are added on top of each other
+	glBlendFunc(GL_ONE, GL_ONE);
+
+	gl_state.useProgram(m_light_program);
+	gl_state.bindBuffer(GL_ARRAY_BUFFER, m_vertex_buffer);
+	gl_state.setPositionAttribute(light_shader.position);
+	gl_state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_element_buffer);
+
+	for (size_t i = 0; i < lights.size(); ++i) {
+		GLfloat rect[4];
+		rect[0] = 2.0f * static_cast<float>(lights[i].pos.x) / VIEW_W - 1.0f;
+		rect[1] = 1.0f - 2.0f * static_cast<float>(lights[i].pos.y) / VIEW_H;
+		rect[2] = 2.0f * static_cast<float>(lights[i].radius.x) / VIEW_W;
+		rect[3] = 2.0f * static_cast<float>(lights[i].radius.y) / VIEW_H;
+
+		GLfloat color[4];
+		color[0] = static_cast<float>(lights[i].color.r) / 255.0f;
+		color[1] = static_cast<float>(lights[i].color.g) / 255.0f;
+		color[2] = static_cast<float>(lights[i].color.b) / 255.0f;
+		color[3] = 1.0f;
+
+		gl_state.uniform4fv(light_shader.rect, rect);
+		gl_state.uniform4fv(light_shader.color, color);
+		gl_state.drawElements(GL_TRIANGLE_STRIP, 4);
+	}
+
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glViewport(view[0], view[1], view[2], view[3]);
+
+	gl_state.bindTexture(2, m_lightmap);
+	lightmap_active = true;
+}
+
+void OpenGLRenderDevice::clearLights()
+{
+	lightmap_active = false;
+}
+
 int OpenGLRenderDevice::render(Sprite *r) {
 	if (r == NULL) {
 		return -1;
@@ -597,63 +997,51 @@ int OpenGLRenderDevice::render(Sprite *r) {
 	if (texture == 0)
 		return 1;
 
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, texture);
+	gl_state.bindTexture(0, texture);
 
 	bool normals = ((int)normalTexture != -1);
 	if (normals)
 	{
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, normalTexture);
+		gl_state.bindTexture(1, normalTexture);
 	}
 
-	composeFrame(m_offset, m_texelOffset , normals);
+	composeFrame(m_offset, m_texelOffset, normals, lightmap_active);
 
 	return 0;
 }
 
-void OpenGLRenderDevice::composeFrame(GLfloat* offset, GLfloat* texelOffset, bool withLight)
+void OpenGLRenderDevice::composeFrame(GLfloat* offset, GLfloat* texelOffset, bool withLight, bool withLightmap)
 {
-	glUseProgram(m_program);
+	gl_state.useProgram(m_program);
 
-	glUniform1i(uniforms.texture, 0);
+	gl_state.uniform1i(uniforms.texture, 0);
 
 	if (withLight)
 	{
-		glUniform1i(uniforms.light, 1);
-		glUniform1i(uniforms.normals, 1);
+		gl_state.uniform1i(uniforms.light, 1);
+		gl_state.uniform1i(uniforms.normals, 1);
 	}
 	else
 	{
-		glUniform1i(uniforms.light, 0);
+		gl_state.uniform1i(uniforms.light, 0);
 	}
-	glUniform1i(uniforms.screenWidth, SCREEN_W);
-	glUniform1i(uniforms.screenHeight, SCREEN_H);
+	gl_state.uniform1i(uniforms.screenWidth, SCREEN_W);
+	gl_state.uniform1i(uniforms.screenHeight, SCREEN_H);
 
-	glUniform4fv(uniforms.offset, 1, offset);
-	glUniform4fv(uniforms.texelOffset, 1, texelOffset);
+	gl_state.uniform1i(uniforms.lightmap, 2);
+	gl_state.uniform1i(uniforms.lightmapEnabled, withLightmap ? 1 : 0);
 
-	glBindBuffer(GL_ARRAY_BUFFER, m_vertex_buffer);
-	glVertexAttribPointer(
-		attributes.position,
-		2, GL_FLOAT, GL_FALSE,
-		sizeof(GLfloat)*2, (void*)0
-	);
+	gl_state.uniform4fv(uniforms.offset, offset);
+	gl_state.uniform4fv(uniforms.texelOffset, texelOffset);
 
-	glEnableVertexAttribArray(attributes.position);
+	gl_state.bindBuffer(GL_ARRAY_BUFFER, m_vertex_buffer);
+	gl_state.setPositionAttribute(attributes.position);
 
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_element_buffer);
-	glDrawElements(
-		GL_TRIANGLE_STRIP,  /* mode */
-		4,                  /* count */
-		GL_UNSIGNED_SHORT,  /* type */
-		(void*)0            /* element array buffer offset */
-	);
+	gl_state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_element_buffer);
+	gl_state.drawElements(GL_TRIANGLE_STRIP, 4);
 	GLenum error = glGetError();
 	if (error)
 		logInfo("Error while calling glDrawElements(): %d", error);
-
-	glDisableVertexAttribArray(attributes.position);
 }
 
 void configureFrameBuffer(GLuint* frameBuffer, GLuint frameTexture, int frame_w, int frame_h)
@@ -661,8 +1049,7 @@ void configureFrameBuffer(GLuint* frameBuffer, GLuint frameTexture, int frame_w,
 	glGenFramebuffers(1, frameBuffer);
 	glBindFramebuffer(GL_FRAMEBUFFER, *frameBuffer);
 
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, frameTexture);
+	gl_state.bindTexture(0, frameTexture);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, frameTexture, 0);
@@ -721,8 +1108,8 @@ int OpenGLRenderDevice::renderToImage(Image* src_image, Rect& src, Image* dest_i
 	if (src_texture == 0)
 		return 1;
 
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, src_texture);
+	// the shader samples unit 0, which configureFrameBuffer() left on the destination
+	gl_state.bindTexture(0, src_texture);
 
 	composeFrame(m_offset, m_texelOffset, false);
 
@@ -755,7 +1142,7 @@ int OpenGLRenderDevice::renderText(
 
 	GLuint texture;
 	glGenTextures(1, &texture);
-	glBindTexture(GL_TEXTURE_2D, texture);
+	gl_state.bindTexture(0, texture);
 
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -769,9 +1156,6 @@ int OpenGLRenderDevice::renderText(
 	if (texture == 0)
 		return 1;
 
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, texture);
-
 	composeFrame(m_offset, m_texelOffset, false);
 
 	return 0;
@@ -795,7 +1179,7 @@ Image * OpenGLRenderDevice::renderTextToImage(FontStyle* font_style, const std::
 		image->h = surface->h;
 		glGenTextures(1, &(image->texture));
 
-		glBindTexture(GL_TEXTURE_2D, image->texture);
+		gl_state.bindTexture(0, image->texture);
 
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -805,6 +1189,7 @@ Image * OpenGLRenderDevice::renderTextToImage(FontStyle* font_style, const std::
 		int error = glGetError();
 		if (error != GL_NO_ERROR)
 			logInfo("Error while calling glTexImage2D(): %d", error);
+		image->setTextureMemory(surface->w * surface->h * 4, surface->w * surface->h * 4);
 		SDL_FreeSurface(surface);
 	}
 
@@ -872,6 +1257,9 @@ void OpenGLRenderDevice::commitFrame() {
 	glFlush();
 	SDL_GL_SwapWindow(window);
 
+	frame_stats = gl_state.stats;
+	gl_state.stats.clear();
+
 	return;
 }
 
@@ -891,17 +1279,33 @@ void OpenGLRenderDevice::destroyContext() {
 		curs = NULL;
 	}
 
-	glDeleteBuffers(1, &m_vertex_buffer);
-	glDeleteBuffers(1, &m_element_buffer);
+	gl_state.deleteBuffer(m_vertex_buffer);
+	gl_state.deleteBuffer(m_element_buffer);
 
-	glDeleteProgram(m_program);
+	gl_state.deleteProgram(m_program);
 	glDeleteShader(m_vertex_shader);
 	glDeleteShader(m_fragment_shader);
 
-	glDeleteProgram(g_program);
+	gl_state.deleteProgram(g_program);
 	glDeleteShader(g_vertex_shader);
 	glDeleteShader(g_fragment_shader);
 
+	if (m_light_program != 0) {
+		gl_state.deleteProgram(m_light_program);
+		glDeleteShader(m_light_vertex_shader);
+		glDeleteShader(m_light_fragment_shader);
+		m_light_program = 0;
+	}
+	if (m_lightmap != 0) {
+		gl_state.deleteTexture(m_lightmap);
+		m_lightmap = 0;
+	}
+	if (m_lightmap_framebuffer != 0) {
+		glDeleteFramebuffers(1, &m_lightmap_framebuffer);
+		m_lightmap_framebuffer = 0;
+	}
+	lightmap_active = false;
+
 	SDL_FreeSurface(titlebar_icon);
 	titlebar_icon = NULL;
 
@@ -936,8 +1340,7 @@ Image *OpenGLRenderDevice::createImage(int width, int height) {
 
 	glGenTextures(1, &(image->texture));
 
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, image->texture);
+	gl_state.bindTexture(0, image->texture);
 
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -948,6 +1351,8 @@ Image *OpenGLRenderDevice::createImage(int width, int height) {
 
 	free(buffer);
 
+	image->setTextureMemory(width * height * channels, width * height * channels);
+
 	return image;
 }
 
@@ -984,7 +1389,9 @@ Image *OpenGLRenderDevice::loadImage(const std::string& filename, const std::str
 
 	// load image
 	OpenGLImage *image = NULL;
-	SDL_Surface *cleanup = IMG_Load(mods->locate(filename).c_str());
+	unsigned long bytes = 0;
+	unsigned long full_bytes = 0;
+	SDL_Surface *cleanup = image_cache->load(mods->locate(filename));
 	if(!cleanup) {
 		if (!errormessage.empty())
 			logError("OpenGLRenderDevice: %s: %s", errormessage.c_str(), IMG_GetError());
@@ -1001,17 +1408,14 @@ Image *OpenGLRenderDevice::loadImage(const std::string& filename, const std::str
 
 		glGenTextures(1, &(image->texture));
 
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, image->texture);
+		gl_state.bindTexture(0, image->texture);
 
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,     GL_CLAMP_TO_EDGE);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,     GL_CLAMP_TO_EDGE);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, surface->w, surface->h, 0, GL_RGBA, GL_UNSIGNED_BYTE, surface->pixels);
-		int error = glGetError();
-		if (error != GL_NO_ERROR)
-			logInfo("Error while calling glTexImage2D(): %d", error);
+		bytes += uploadTexture(surface, image->reduced);
+		full_bytes += surface->w * surface->h * 4;
 
 		SDL_FreeSurface(surface);
 		SDL_FreeSurface(cleanup);
@@ -1020,23 +1424,21 @@ Image *OpenGLRenderDevice::loadImage(const std::string& filename, const std::str
 	std::string normalFileName = filename.substr(0, filename.size() - 4) + "_N.png";
 	normalFileName = mods->locate(normalFileName);
 
-	SDL_Surface *cleanupN = IMG_Load(normalFileName.c_str());
+	SDL_Surface *cleanupN = image_cache->load(normalFileName);
 	if(cleanupN && cleanupN->w == image->w && cleanupN->h == image->h) {
 		SDL_Surface *surfaceN = SDL_ConvertSurfaceFormat(cleanupN, SDL_PIXELFORMAT_ABGR8888, 0);
 
 		glGenTextures(1, &(image->normalTexture));
 
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, image->normalTexture);
+		gl_state.bindTexture(0, image->normalTexture);
 
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,     GL_CLAMP_TO_EDGE);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,     GL_CLAMP_TO_EDGE);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, surfaceN->w, surfaceN->h, 0, GL_RGBA, GL_UNSIGNED_BYTE, surfaceN->pixels);
-		int error = glGetError();
-		if (error != GL_NO_ERROR)
-			logInfo("Error while calling glTexImage2D(): %d", error);
+		bool reduced_normals = false;
+		bytes += uploadTexture(surfaceN, reduced_normals);
+		full_bytes += surfaceN->w * surfaceN->h * 4;
 
 		SDL_FreeSurface(surfaceN);
 		SDL_FreeSurface(cleanupN);
@@ -1046,11 +1448,91 @@ Image *OpenGLRenderDevice::loadImage(const std::string& filename, const std::str
 		SDL_FreeSurface(cleanupN);
 	}
 
+	if (image)
+		image->setTextureMemory(bytes, full_bytes);
+
 	// store image to cache
 	cacheStore(filename, image);
 	return image;
 }
 
+void OpenGLRenderDevice::addTextureMemory(unsigned long bytes, unsigned long full_bytes) {
+	texture_memory.bytes += bytes;
+	texture_memory.full_bytes += full_bytes;
+}
+
+void OpenGLRenderDevice::removeTextureMemory(unsigned long bytes, unsigned long full_bytes) {
+	texture_memory.bytes -= std::min(bytes, texture_memory.bytes);
+	texture_memory.full_bytes -= std::min(full_bytes, texture_memory.full_bytes);
+}
+
+/**
+ * Upload a 32-bit RGBA surface to the bound texture, at the depth and resolution
+ * set by TEXTURE_DEPTH and TEXTURE_HALF_SIZE. Sets reduced if the texture is
+ * smaller than the surface. Returns the size of the texture in bytes.
+ */
+unsigned long OpenGLRenderDevice::uploadTexture(SDL_Surface* surface, bool& reduced) {
+	int width = surface->w;
+	int height = surface->h;
+	int pitch = surface->pitch;
+	const Uint8* pixels = static_cast<const Uint8*>(surface->pixels);
+
+	// the sprite coordinates are relative to the image size, so a half size texture doesn't need any other changes
+	std::vector<Uint8> half;
+	if (TEXTURE_HALF_SIZE && width * height >= TEXTURE_HALF_SIZE_MIN_AREA && width % 2 == 0 && height % 2 == 0) {
+		halveTexture(pixels, pitch, width, height, half);
+		width /= 2;
+		height /= 2;
+		pitch = width * 4;
+		pixels = &half[0];
+	}
+
+	unsigned long bytes = 0;
+
+	if (TEXTURE_DEPTH == 16) {
+		bool opaque = true;
+		for (int y = 0; y < height && opaque; ++y) {
+			for (int x = 0; x < width && opaque; ++x) {
+				opaque = pixels[y * pitch + x * 4 + 3] == 255;
+			}
+		}
+
+		std::vector<Uint16> packed(width * height);
+		for (int y = 0; y < height; ++y) {
+			const Uint8* row = pixels + y * pitch;
+			for (int x = 0; x < width; ++x) {
+				const Uint8* p = row + x * 4;
+				if (opaque)
+					packed[y * width + x] = static_cast<Uint16>((quantize(p[0], 31) << 11) | (quantize(p[1], 63) << 5) | quantize(p[2], 31));
+				else
+					packed[y * width + x] = static_cast<Uint16>((quantize(p[0], 15) << 12) | (quantize(p[1], 15) << 8) | (quantize(p[2], 15) << 4) | quantize(p[3], 15));
+			}
+		}
+
+		// rows of 16-bit pixels are not always a multiple of 4 bytes long
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+		if (opaque)
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, &packed[0]);
+		else
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, &packed[0]);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+		bytes = width * height * 2;
+		reduced = true;
+	}
+	else {
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+		bytes = width * height * 4;
+		reduced = (width != surface->w);
+	}
+
+	int error = glGetError();
+	if (error != GL_NO_ERROR)
+		logInfo("Error while calling glTexImage2D(): %d", error);
+
+	return bytes;
+}
+
 void OpenGLRenderDevice::windowResize() {
 	int w,h;
 	SDL_GetWindowSize(window, &w, &h);
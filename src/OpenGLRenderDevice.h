@@ -49,6 +49,58 @@ GLuint createBuffer(GLenum target, const void *buffer_data, GLsizei buffer_size)
 int preparePrimitiveProgram();
 void drawPrimitive(GLfloat* vertexData, const Color& color, DRAW_TYPE type);
 
+/**
+ * Shadow copy of the GL state that changes between draw calls
+ *
+ * Texture binds, buffer binds, program switches and uniform writes that would
+ * not change anything are dropped before they reach the driver. All of these
+ * state changes have to go through this class, otherwise the shadow copy will
+ * no longer match the context.
+ */
+class OpenGLState {
+private:
+	static const int TEXTURE_UNITS = 3; // image, normal map, light map
+
+	class ProgramUniforms {
+	public:
+		GLuint program;
+		std::vector<bool> is_set;
+		std::vector<GLint> ints;
+		std::vector<GLfloat> floats; // 4 per location
+	};
+
+	ProgramUniforms* getUniforms(GLint location);
+
+	GLuint active_unit;
+	GLuint textures[TEXTURE_UNITS];
+	GLuint array_buffer;
+	GLuint element_buffer;
+	GLuint program;
+	GLint attrib_enabled; // only one vertex attribute is used at a time
+	GLint attrib_location;
+	GLuint attrib_buffer;
+	std::vector<ProgramUniforms> uniforms;
+
+public:
+	OpenGLState();
+
+	void reset();
+
+	void bindTexture(GLuint unit, GLuint texture);
+	void bindBuffer(GLenum target, GLuint buffer);
+	void useProgram(GLuint _program);
+	void uniform1i(GLint location, GLint value);
+	void uniform4fv(GLint location, const GLfloat* value);
+	void setPositionAttribute(GLint location);
+	void drawElements(GLenum mode, GLsizei count);
+
+	void deleteTexture(GLuint texture);
+	void deleteBuffer(GLuint buffer);
+	void deleteProgram(GLuint _program);
+
+	RenderStats stats;
+};
+
 /** OpenGL Image */
 class OpenGLImage : public Image {
 public:
@@ -59,12 +111,18 @@ public:
 
 	void fillWithColor(const Color& color);
 	void drawPixel(int x, int y, const Color& color);
+	void writePixels(const Rect& area, const std::vector<Color>& pixels);
 	Image* resize(int width, int height);
 
+	void setTextureMemory(unsigned long bytes, unsigned long full_bytes);
+
 	GLuint texture;
 	GLuint normalTexture;
 	int w;
 	int h;
+	bool reduced; // the texture has a lower depth or resolution than the image, so its pixels can't be written
+	unsigned long texture_bytes;
+	unsigned long texture_full_bytes;
 };
 
 class OpenGLRenderDevice : public RenderDevice {
@@ -91,14 +149,24 @@ public:
 	void resetGamma();
 	void updateTitleBar();
 
+	void setLights(const Color& ambient, const std::vector<RenderLight>& lights);
+	void clearLights();
+
 	Image* loadImage(const std::string& filename,
 								const std::string& errormessage = "Couldn't load image",
 								bool IfNotFoundExit = false);
+
+	void addTextureMemory(unsigned long bytes, unsigned long full_bytes);
+	void removeTextureMemory(unsigned long bytes, unsigned long full_bytes);
+
 private:
+	unsigned long uploadTexture(SDL_Surface* surface, bool& reduced);
 	void drawLine(int x0, int y0, int x1, int y1, const Color& color);
 
 	int buildResources();
-	void composeFrame(GLfloat* offset, GLfloat* texelOffset, bool withLight = false);
+	int buildLightResources();
+	bool createLightmap(const Point& size);
+	void composeFrame(GLfloat* offset, GLfloat* texelOffset, bool withLight = false, bool withLightmap = false);
 
 	SDL_Window *window;
 	SDL_GLContext renderer;
@@ -116,12 +184,26 @@ private:
 		GLint screenHeight;
 		GLint offset;
 		GLint texelOffset;
+		GLint lightmap;
+		GLint lightmapEnabled;
 	} uniforms;
 
 	struct {
 		GLint position;
 	} attributes;
 
+	// the lights of the map are drawn to a low resolution texture, which is sampled when drawing the map
+	GLuint m_light_vertex_shader, m_light_fragment_shader, m_light_program;
+	GLuint m_lightmap, m_lightmap_framebuffer;
+	Point lightmap_size;
+	bool lightmap_active;
+
+	struct {
+		GLint position;
+		GLint rect;
+		GLint color;
+	} light_shader;
+
 	GLushort m_elementBufferData[4];
 	GLfloat m_positionData[8];
 	GLfloat m_offset[4]; //x, y, width, height
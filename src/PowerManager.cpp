@@ -59,7 +59,7 @@ void PowerManager::loadEffects() {
 	FileParser infile;
 
 	// @CLASS Effects|Description of powers/effects.txt
-	if (!infile.open("powers/effects.txt"))
+	if (!infile.openCached("powers/effects.txt"))
 		return;
 
 	while (infile.next()) {
@@ -140,7 +140,7 @@ void PowerManager::loadPowers() {
 	FileParser infile;
 
 	// @CLASS Powers|Description of powers/powers.txt
-	if (!infile.open("powers/powers.txt"))
+	if (!infile.openCached("powers/powers.txt"))
 		return;
 
 	bool clear_post_effects = true;
@@ -321,6 +321,11 @@ void PowerManager::loadPowers() {
 		else if (infile.key == "floor")
 			// @ATTR power.floor|bool|The hazard is drawn between the background and the object layer.
 			powers[input_id].floor = toBool(infile.val);
+		else if (infile.key == "light") {
+			// @ATTR power.light|float, color|Radius (in map units) and color of a light that follows the hazard. Only shown on maps with "ambient_light".
+			powers[input_id].light.radius = toFloat(popFirstString(infile.val));
+			powers[input_id].light.color = toRGB(infile.val);
+		}
 		else if (infile.key == "complete_animation")
 			// @ATTR power.complete_animation|bool|For hazards; Play the entire animation, even if the hazard has hit a target.
 			powers[input_id].complete_animation = toBool(infile.val);
@@ -798,6 +803,7 @@ void PowerManager::initHazard(int power_index, StatBlock *src_stats, const FPoin
 
 	haz->base_lifespan = haz->lifespan = powers[power_index].lifespan;
 	haz->on_floor = powers[power_index].floor;
+	haz->light = powers[power_index].light;
 	haz->base_speed = powers[power_index].speed;
 	haz->complete_animation = powers[power_index].complete_animation;
 
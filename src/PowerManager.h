@@ -156,6 +156,7 @@ public:
 	float speed; // for missile hazards, tiles per frame
 	int lifespan; // how long the hazard/animation lasts
 	bool floor; // the hazard is drawn between the background and object layers
+	LightSource light; // the hazard lights up its surroundings
 	bool complete_animation;
 	float charge_speed;
 	float attack_speed;
@@ -297,6 +298,7 @@ public:
 		, speed(0)
 		, lifespan(0)
 		, floor(false)
+		, light()
 		, complete_animation(false)
 		, charge_speed(0.0f)
 		, attack_speed(100.0f)
@@ -165,6 +165,23 @@ Image * Sprite::getGraphics() {
 	return static_cast<Image *>(image);
 }
 
+RenderStats::RenderStats() {
+	clear();
+}
+
+void RenderStats::clear() {
+	draws = 0;
+	texture_binds = 0;
+	program_switches = 0;
+	uniform_writes = 0;
+	skipped = 0;
+}
+
+TextureMemory::TextureMemory()
+	: bytes(0)
+	, full_bytes(0) {
+}
+
 
 /*
  * RenderDevice
@@ -286,6 +303,26 @@ bool RenderDevice::reloadGraphics() {
 	return false;
 }
 
+/**
+ * Counters of the last completed frame
+ */
+const RenderStats& RenderDevice::getFrameStats() {
+	return frame_stats;
+}
+
+const TextureMemory& RenderDevice::getTextureMemory() {
+	return texture_memory;
+}
+
+/**
+ * Devices without a lighting pass draw everything fully lit
+ */
+void RenderDevice::setLights(const Color&, const std::vector<RenderLight>&) {
+}
+
+void RenderDevice::clearLights() {
+}
+
 void RenderDevice::freeImage(Image *image) {
 	if (!image) return;
 
@@ -34,6 +34,14 @@ enum {
 	RENDERABLE_BLEND_ADD = 1,
 };
 
+// what a Renderable belongs to, so the mouse can pick it once it is drawn
+enum {
+	PICK_NONE = 0,
+	PICK_ENEMY = 1,
+	PICK_NPC = 2,
+	PICK_LOOT = 3,
+};
+
 /** A Sprite representation
  *
  * A Sprite is instantiated from a Image instance using
@@ -123,6 +131,7 @@ public:
 
 	virtual void fillWithColor(const Color& color) = 0;
 	virtual void drawPixel(int x, int y, const Color& color) = 0;
+	virtual void writePixels(const Rect& area, const std::vector<Color>& pixels) = 0;
 	virtual Image* resize(int width, int height) = 0;
 
 	class Sprite *createSprite(bool clipToSize = true);
@@ -152,6 +161,9 @@ public:
 	Color color_mod;
 	uint8_t alpha_mod;
 
+	uint8_t pick_type; // one of PICK_*
+	size_t pick_index; // of the Enemy, NPC or Loot in the list of its manager
+
 	Renderable()
 		: image(NULL)
 		, src(Rect())
@@ -160,11 +172,49 @@ public:
 		, prio(0)
 		, blend_mode(RENDERABLE_BLEND_NORMAL)
 		, color_mod(255, 255, 255)
-		, alpha_mod(255) {
+		, alpha_mod(255)
+		, pick_type(PICK_NONE)
+		, pick_index(0) {
 	}
 };
 
+/**
+ * Counters for the work a render device submitted during one frame.
+ * Devices that don't track a counter leave it at 0.
+ */
+class RenderStats {
+public:
+	unsigned draws;
+	unsigned texture_binds;
+	unsigned program_switches;
+	unsigned uniform_writes;
+	unsigned skipped; // state changes that were dropped because the state was already set
+
+	RenderStats();
+	void clear();
+};
 
+/**
+ * Memory used by the textures of a render device, in bytes.
+ * Devices that don't track it leave it at 0.
+ */
+class TextureMemory {
+public:
+	unsigned long bytes;
+	unsigned long full_bytes; // what the same textures would use as 32-bit images at full resolution
+
+	TextureMemory();
+};
+
+/**
+ * A light in screen space, see RenderDevice::setLights()
+ */
+class RenderLight {
+public:
+	Point pos;
+	Point radius; // horizontal and vertical radius, in pixels
+	Color color;
+};
 
 /** Provide abstract interface for FLARE engine rendering devices.
  *
@@ -217,6 +267,13 @@ public:
 
 	bool reloadGraphics();
 
+	const RenderStats& getFrameStats();
+	const TextureMemory& getTextureMemory();
+
+	/** Lighting of everything drawn until clearLights(). Not supported by all devices. */
+	virtual void setLights(const Color& ambient, const std::vector<RenderLight>& lights);
+	virtual void clearLights();
+
 protected:
 	/* Compute clipping and global position from local frame. */
 	bool localToGlobal(Sprite *r);
@@ -239,6 +296,11 @@ protected:
 	Rect m_clip;
 	Rect m_dest;
 
+	RenderStats stats; // the frame in progress, moved to frame_stats by commitFrame()
+	RenderStats frame_stats;
+
+	TextureMemory texture_memory;
+
 	/* Stores the system gamma levels so they can be restored later */
 	uint16_t gamma_r[256];
 	uint16_t gamma_g[256];
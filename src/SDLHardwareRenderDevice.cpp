@@ -70,11 +70,32 @@ void SDLHardwareImage::fillWithColor(const Color& color) {
 void SDLHardwareImage::drawPixel(int x, int y, const Color& color) {
 	if (!surface) return;
 
-	SDL_SetRenderTarget(renderer, surface);
-	SDL_SetTextureBlendMode(surface, SDL_BLENDMODE_BLEND);
-	SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-	SDL_RenderDrawPoint(renderer, x, y);
-	SDL_SetRenderTarget(renderer, NULL);
+	// avoids switching the render target back and forth for a single pixel
+	writePixels(Rect(x, y, 1, 1), std::vector<Color>(1, color));
+}
+
+/*
+ * Copy a block of pixels (row by row, area.w * area.h) to the image with a single texture upload
+ */
+void SDLHardwareImage::writePixels(const Rect& area, const std::vector<Color>& pixels) {
+	if (!surface || area.w <= 0 || area.h <= 0) return;
+	if (pixels.size() < static_cast<size_t>(area.w * area.h)) return;
+
+	// textures are created as ARGB8888
+	std::vector<Uint32> buffer(area.w * area.h);
+	for (size_t i = 0; i < buffer.size(); ++i) {
+		const Color& color = pixels[i];
+		buffer[i] = (static_cast<Uint32>(color.a) << 24) | (static_cast<Uint32>(color.r) << 16) | (static_cast<Uint32>(color.g) << 8) | static_cast<Uint32>(color.b);
+	}
+
+	int w, h;
+	SDL_QueryTexture(surface, NULL, NULL, &w, &h);
+	if (area.x < 0 || area.y < 0 || area.x + area.w > w || area.y + area.h > h) return;
+
+	SDL_Rect dest = area;
+	if (SDL_UpdateTexture(surface, &dest, &buffer[0], area.w * static_cast<int>(sizeof(Uint32))) != 0) {
+		logError("SDLHardwareImage: SDL_UpdateTexture failed: %s", SDL_GetError());
+	}
 }
 
 Image* SDLHardwareImage::resize(int width, int height) {
@@ -256,6 +277,7 @@ int SDLHardwareRenderDevice::createContext(bool allow_fallback) {
 }
 
 int SDLHardwareRenderDevice::render(Renderable& r, Rect& dest) {
+	stats.draws++;
 	dest.w = r.src.w;
 	dest.h = r.src.h;
     SDL_Rect src = r.src;
@@ -301,6 +323,8 @@ int SDLHardwareRenderDevice::render(Sprite *r) {
 	m_dest.w = m_clip.w;
 	m_dest.h = m_clip.h;
 
+	stats.draws++;
+
     SDL_Rect src = m_clip;
     SDL_Rect dest = m_dest;
 	SDL_SetRenderTarget(renderer, texture);
@@ -320,7 +344,14 @@ int SDLHardwareRenderDevice::renderToImage(Image* src_image, Rect& src, Image* d
     SDL_Rect _dest = dest;
 
 	SDL_SetTextureBlendMode(static_cast<SDLHardwareImage *>(dest_image)->surface, SDL_BLENDMODE_BLEND);
-	SDL_RenderCopy(renderer, static_cast<SDLHardwareImage *>(src_image)->surface, &_src, &_dest);
+
+	// the source keeps the mods of its last render(), and atlas pages are shared by many sprites
+	SDL_Texture* src_texture = static_cast<SDLHardwareImage *>(src_image)->surface;
+	SDL_SetTextureBlendMode(src_texture, SDL_BLENDMODE_BLEND);
+	SDL_SetTextureColorMod(src_texture, 255, 255, 255);
+	SDL_SetTextureAlphaMod(src_texture, 255);
+
+	SDL_RenderCopy(renderer, src_texture, &_src, &_dest);
 	SDL_SetRenderTarget(renderer, NULL);
 	return 0;
 }
@@ -415,6 +446,9 @@ void SDLHardwareRenderDevice::commitFrame() {
 	SDL_RenderPresent(renderer);
 	inpt->window_resized = false;
 
+	frame_stats = stats;
+	stats.clear();
+
 	return;
 }
 
@@ -513,7 +547,11 @@ Image *SDLHardwareRenderDevice::loadImage(const std::string&filename, const std:
 	SDLHardwareImage *image = new SDLHardwareImage(this, renderer);
 	if (!image) return NULL;
 
-	image->surface = IMG_LoadTexture(renderer, mods->locate(filename).c_str());
+	SDL_Surface *cleanup = image_cache->load(mods->locate(filename));
+	if (cleanup) {
+		image->surface = SDL_CreateTextureFromSurface(renderer, cleanup);
+		SDL_FreeSurface(cleanup);
+	}
 
 	if(image->surface == NULL) {
 		delete image;
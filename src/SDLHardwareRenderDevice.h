@@ -52,6 +52,7 @@ public:
 
 	void fillWithColor(const Color& color);
 	void drawPixel(int x, int y, const Color& color);
+	void writePixels(const Rect& area, const std::vector<Color>& pixels);
 	Image* resize(int width, int height);
 
 	SDL_Renderer *renderer;
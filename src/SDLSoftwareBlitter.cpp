@@ -0,0 +1,532 @@
+/*
+Copyright © 2016 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+#include "SDLSoftwareBlitter.h"
+
+#include <cmath>
+#include <iomanip>
+
+// The vector kernels address the color channels by byte, which assumes the
+// little-endian layout of ARGB8888 (B, G, R, A in memory)
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BLITTER_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define BLITTER_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+BlitParams::BlitParams()
+	: blend_mode(BLIT_BLEND_NORMAL)
+	, color_mod_r(255)
+	, color_mod_g(255)
+	, color_mod_b(255)
+	, alpha_mod(255)
+	, premultiplied(false) {
+}
+
+/**
+ * The per-blit state used by the row kernels
+ * The color mod is pre-scaled by the alpha mod, since the source is premultiplied
+ */
+class BlitKernel {
+public:
+	bool premultiplied;
+	bool modulated;
+	bool additive;
+	Uint8 mod_r;
+	Uint8 mod_g;
+	Uint8 mod_b;
+	Uint8 mod_a;
+
+	explicit BlitKernel(const BlitParams& params);
+};
+
+/**
+ * Exact x/255 (rounded) for x in [0, 255*255]
+ */
+static inline Uint32 div255(Uint32 x) {
+	x += 128;
+	return (x + (x >> 8)) >> 8;
+}
+
+Uint8 premultiplyChannel(Uint8 c, Uint8 a) {
+	return static_cast<Uint8>(div255(static_cast<Uint32>(c) * a));
+}
+
+BlitKernel::BlitKernel(const BlitParams& params)
+	: premultiplied(params.premultiplied)
+	, modulated(params.color_mod_r != 255 || params.color_mod_g != 255 || params.color_mod_b != 255 || params.alpha_mod != 255)
+	, additive(params.blend_mode == BLIT_BLEND_ADD)
+	, mod_r(premultiplyChannel(params.color_mod_r, params.alpha_mod))
+	, mod_g(premultiplyChannel(params.color_mod_g, params.alpha_mod))
+	, mod_b(premultiplyChannel(params.color_mod_b, params.alpha_mod))
+	, mod_a(params.alpha_mod) {
+}
+
+static inline Uint32 blendPixel(Uint32 s, Uint32 d, const BlitKernel& k) {
+	Uint32 sa = s >> 24;
+	if (sa == 0)
+		return d;
+
+	Uint32 sr = (s >> 16) & 0xff;
+	Uint32 sg = (s >> 8) & 0xff;
+	Uint32 sb = s & 0xff;
+
+	if (!k.premultiplied) {
+		sr = div255(sr * sa);
+		sg = div255(sg * sa);
+		sb = div255(sb * sa);
+	}
+	else if (sa == 255 && !k.modulated && !k.additive) {
+		return s;
+	}
+
+	if (k.modulated) {
+		sr = div255(sr * k.mod_r);
+		sg = div255(sg * k.mod_g);
+		sb = div255(sb * k.mod_b);
+		sa = div255(sa * k.mod_a);
+	}
+
+	Uint32 da = d >> 24;
+	Uint32 dr = (d >> 16) & 0xff;
+	Uint32 dg = (d >> 8) & 0xff;
+	Uint32 db = d & 0xff;
+
+	if (k.additive) {
+		dr = std::min<Uint32>(dr + sr, 255);
+		dg = std::min<Uint32>(dg + sg, 255);
+		db = std::min<Uint32>(db + sb, 255);
+	}
+	else {
+		Uint32 inv = 255 - sa;
+		dr = std::min<Uint32>(sr + div255(dr * inv), 255);
+		dg = std::min<Uint32>(sg + div255(dg * inv), 255);
+		db = std::min<Uint32>(sb + div255(db * inv), 255);
+		da = std::min<Uint32>(sa + div255(da * inv), 255);
+	}
+
+	return (da << 24) | (dr << 16) | (dg << 8) | db;
+}
+
+#if defined(BLITTER_SSE2)
+
+static inline __m128i div255_epu16(__m128i x) {
+	x = _mm_add_epi16(x, _mm_set1_epi16(128));
+	return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+/**
+ * Copy the alpha of each of the two unpacked pixels to all four of its lanes
+ */
+static inline __m128i broadcastAlpha(__m128i x) {
+	x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(3, 3, 3, 3));
+	return _mm_shufflehi_epi16(x, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+/**
+ * Blend two pixels, unpacked to 16 bits per channel
+ */
+static inline __m128i blendPixels(__m128i s, __m128i d, const BlitKernel& k, __m128i alpha_lanes, __m128i mod) {
+	const __m128i max = _mm_set1_epi16(255);
+
+	if (!k.premultiplied) {
+		// multiply the colors by alpha, and alpha by 255 to leave it unchanged
+		__m128i a = _mm_or_si128(_mm_andnot_si128(alpha_lanes, broadcastAlpha(s)), _mm_and_si128(alpha_lanes, max));
+		s = div255_epu16(_mm_mullo_epi16(s, a));
+	}
+
+	if (k.modulated)
+		s = div255_epu16(_mm_mullo_epi16(s, mod));
+
+	if (k.additive)
+		return _mm_add_epi16(d, _mm_andnot_si128(alpha_lanes, s));
+
+	__m128i inv = _mm_sub_epi16(max, broadcastAlpha(s));
+	return _mm_add_epi16(s, div255_epu16(_mm_mullo_epi16(d, inv)));
+}
+
+static void blendRow(const Uint32* src, Uint32* dest, int count, const BlitKernel& k) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i opaque = _mm_set1_epi32(255);
+	const __m128i alpha_lanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+	const __m128i mod = _mm_set_epi16(k.mod_a, k.mod_r, k.mod_g, k.mod_b, k.mod_a, k.mod_r, k.mod_g, k.mod_b);
+	const bool copy_opaque = k.premultiplied && !k.modulated && !k.additive;
+
+	for (; count >= 4; count -= 4, src += 4, dest += 4) {
+		__m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+
+		// most sprites have large fully transparent or fully opaque areas
+		__m128i alpha = _mm_srli_epi32(s, 24);
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, zero)) == 0xffff)
+			continue;
+		if (copy_opaque && _mm_movemask_epi8(_mm_cmpeq_epi32(alpha, opaque)) == 0xffff) {
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest), s);
+			continue;
+		}
+
+		__m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dest));
+		__m128i lo = blendPixels(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), k, alpha_lanes, mod);
+		__m128i hi = blendPixels(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), k, alpha_lanes, mod);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_packus_epi16(lo, hi));
+	}
+
+	for (; count > 0; --count, ++src, ++dest) {
+		*dest = blendPixel(*src, *dest, k);
+	}
+}
+
+#elif defined(BLITTER_NEON)
+
+/**
+ * Exact x/255 (rounded) for x in [0, 255*255], narrowed to 8 bits
+ */
+static inline uint8x8_t div255_u8(uint16x8_t x) {
+	return vraddhn_u16(x, vrshrq_n_u16(x, 8));
+}
+
+static void blendRow(const Uint32* src, Uint32* dest, int count, const BlitKernel& k) {
+	static const uint8_t alpha_index_data[8] = {3, 3, 3, 3, 7, 7, 7, 7};
+	static const uint8_t alpha_lanes_data[8] = {0, 0, 0, 255, 0, 0, 0, 255};
+	const uint8x8_t alpha_index = vld1_u8(alpha_index_data);
+	const uint8x8_t alpha_lanes = vld1_u8(alpha_lanes_data);
+	const uint8_t mod_data[8] = {k.mod_b, k.mod_g, k.mod_r, k.mod_a, k.mod_b, k.mod_g, k.mod_r, k.mod_a};
+	const uint8x8_t mod = vld1_u8(mod_data);
+
+	for (; count >= 2; count -= 2, src += 2, dest += 2) {
+		if ((src[0] >> 24) == 0 && (src[1] >> 24) == 0)
+			continue;
+
+		uint8x8_t s = vreinterpret_u8_u32(vld1_u32(src));
+		uint8x8_t d = vreinterpret_u8_u32(vld1_u32(dest));
+
+		if (!k.premultiplied) {
+			// multiply the colors by alpha, and alpha by 255 to leave it unchanged
+			s = div255_u8(vmull_u8(s, vorr_u8(vtbl1_u8(s, alpha_index), alpha_lanes)));
+		}
+
+		if (k.modulated)
+			s = div255_u8(vmull_u8(s, mod));
+
+		if (k.additive) {
+			d = vqadd_u8(d, vbic_u8(s, alpha_lanes));
+		}
+		else {
+			uint8x8_t inv = vmvn_u8(vtbl1_u8(s, alpha_index));
+			d = vqadd_u8(s, div255_u8(vmull_u8(d, inv)));
+		}
+
+		vst1_u32(dest, vreinterpret_u32_u8(d));
+	}
+
+	for (; count > 0; --count, ++src, ++dest) {
+		*dest = blendPixel(*src, *dest, k);
+	}
+}
+
+#else
+
+static void blendRow(const Uint32* src, Uint32* dest, int count, const BlitKernel& k) {
+	for (; count > 0; --count, ++src, ++dest) {
+		*dest = blendPixel(*src, *dest, k);
+	}
+}
+
+#endif
+
+const char* getBlitterName() {
+#if defined(BLITTER_SSE2)
+	return "SSE2";
+#elif defined(BLITTER_NEON)
+	return "NEON";
+#else
+	return "scalar";
+#endif
+}
+
+bool isARGB8888(const SDL_Surface* surface) {
+	return surface->format->format == SDL_PIXELFORMAT_ARGB8888;
+}
+
+/**
+ * Other pixel formats (e.g. 8-bit text from TTF_RenderUTF8_Solid) are drawn by SDL itself
+ */
+static int blitSurfaceSDL(SDL_Surface* src, const SDL_Rect* src_rect, SDL_Surface* dest, SDL_Rect* dest_rect, const BlitParams& params) {
+	if (params.blend_mode == BLIT_BLEND_ADD)
+		SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_ADD);
+	else
+		SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_BLEND);
+
+	SDL_SetSurfaceColorMod(src, params.color_mod_r, params.color_mod_g, params.color_mod_b);
+	SDL_SetSurfaceAlphaMod(src, params.alpha_mod);
+
+	return SDL_BlitSurface(src, src_rect, dest, dest_rect);
+}
+
+/**
+ * Clip a blit the same way as SDL_BlitSurface():
+ * src_rect is clipped to the source surface, the result is clipped to clip.
+ * On input, only the position of dest_rect is used. On output, src_rect and
+ * dest_rect hold the area that is actually drawn. Returns false if nothing is left.
+ */
+bool clipBlit(const SDL_Surface* src, SDL_Rect& src_rect, const SDL_Rect& clip, SDL_Rect& dest_rect) {
+	int src_x = src_rect.x;
+	int src_y = src_rect.y;
+	int w = src_rect.w;
+	int h = src_rect.h;
+	int dest_x = dest_rect.x;
+	int dest_y = dest_rect.y;
+
+	if (src_x < 0) {
+		w += src_x;
+		dest_x -= src_x;
+		src_x = 0;
+	}
+	if (src_y < 0) {
+		h += src_y;
+		dest_y -= src_y;
+		src_y = 0;
+	}
+	w = std::min(w, src->w - src_x);
+	h = std::min(h, src->h - src_y);
+
+	int offset;
+
+	offset = clip.x - dest_x;
+	if (offset > 0) {
+		w -= offset;
+		src_x += offset;
+		dest_x += offset;
+	}
+	offset = dest_x + w - (clip.x + clip.w);
+	if (offset > 0)
+		w -= offset;
+
+	offset = clip.y - dest_y;
+	if (offset > 0) {
+		h -= offset;
+		src_y += offset;
+		dest_y += offset;
+	}
+	offset = dest_y + h - (clip.y + clip.h);
+	if (offset > 0)
+		h -= offset;
+
+	if (w <= 0 || h <= 0) {
+		dest_rect.w = 0;
+		dest_rect.h = 0;
+		return false;
+	}
+
+	src_rect.x = src_x;
+	src_rect.y = src_y;
+	src_rect.w = dest_rect.w = w;
+	src_rect.h = dest_rect.h = h;
+	dest_rect.x = dest_x;
+	dest_rect.y = dest_y;
+
+	return true;
+}
+
+/**
+ * Blit an already clipped area between two ARGB8888 surfaces
+ * Both surfaces have to be locked if needed. Different threads may blit to the
+ * same surface at the same time, as long as their destination areas don't overlap.
+ */
+void blitClipped(const SDL_Surface* src, const SDL_Rect& src_rect, SDL_Surface* dest, const SDL_Rect& dest_rect, const BlitParams& params) {
+	const BlitKernel kernel(params);
+	const Uint8* src_row = static_cast<const Uint8*>(src->pixels) + src_rect.y * src->pitch + src_rect.x * 4;
+	Uint8* dest_row = static_cast<Uint8*>(dest->pixels) + dest_rect.y * dest->pitch + dest_rect.x * 4;
+
+	for (int i = 0; i < dest_rect.h; ++i) {
+		blendRow(reinterpret_cast<const Uint32*>(src_row), reinterpret_cast<Uint32*>(dest_row), dest_rect.w, kernel);
+		src_row += src->pitch;
+		dest_row += dest->pitch;
+	}
+}
+
+/**
+ * Blit src to dest like SDL_BlitSurface()
+ * The width and height of dest_rect are ignored, and it is set to the final blit area.
+ */
+int blitSurface(SDL_Surface* src, const SDL_Rect* src_rect, SDL_Surface* dest, SDL_Rect* dest_rect, const BlitParams& params) {
+	if (!src || !dest)
+		return -1;
+
+	if (!isARGB8888(src) || !isARGB8888(dest))
+		return blitSurfaceSDL(src, src_rect, dest, dest_rect, params);
+
+	SDL_Rect _src;
+	if (src_rect) {
+		_src = *src_rect;
+	}
+	else {
+		_src.x = _src.y = 0;
+		_src.w = src->w;
+		_src.h = src->h;
+	}
+
+	SDL_Rect _dest;
+	_dest.x = dest_rect ? dest_rect->x : 0;
+	_dest.y = dest_rect ? dest_rect->y : 0;
+
+	bool visible = clipBlit(src, _src, dest->clip_rect, _dest);
+
+	if (dest_rect) {
+		dest_rect->x = _dest.x;
+		dest_rect->y = _dest.y;
+		dest_rect->w = _dest.w;
+		dest_rect->h = _dest.h;
+	}
+
+	if (!visible)
+		return 0;
+
+	if (SDL_MUSTLOCK(src))
+		SDL_LockSurface(src);
+	if (SDL_MUSTLOCK(dest))
+		SDL_LockSurface(dest);
+
+	blitClipped(src, _src, dest, _dest, params);
+
+	if (SDL_MUSTLOCK(dest))
+		SDL_UnlockSurface(dest);
+	if (SDL_MUSTLOCK(src))
+		SDL_UnlockSurface(src);
+
+	return 0;
+}
+
+/**
+ * Convert an ARGB8888 surface from straight to premultiplied alpha
+ */
+void premultiplySurface(SDL_Surface* surface) {
+	if (!surface || !isARGB8888(surface))
+		return;
+
+	if (SDL_MUSTLOCK(surface))
+		SDL_LockSurface(surface);
+
+	for (int y = 0; y < surface->h; ++y) {
+		Uint32* p = reinterpret_cast<Uint32*>(static_cast<Uint8*>(surface->pixels) + y * surface->pitch);
+
+		for (int x = 0; x < surface->w; ++x, ++p) {
+			Uint32 a = *p >> 24;
+			if (a == 255)
+				continue;
+
+			if (a == 0) {
+				*p = 0;
+				continue;
+			}
+
+			Uint32 r = div255(((*p >> 16) & 0xff) * a);
+			Uint32 g = div255(((*p >> 8) & 0xff) * a);
+			Uint32 b = div255((*p & 0xff) * a);
+			*p = (a << 24) | (r << 16) | (g << 8) | b;
+		}
+	}
+
+	if (SDL_MUSTLOCK(surface))
+		SDL_UnlockSurface(surface);
+}
+
+void benchmarkBlitter(std::vector<std::string>& results) {
+	const int SRC_SIZE = 64;
+	const int DEST_SIZE = 512;
+	const int ITERATIONS = 2000;
+
+	Uint32 rmask, gmask, bmask, amask;
+	int bpp;
+	SDL_PixelFormatEnumToMasks(SDL_PIXELFORMAT_ARGB8888, &bpp, &rmask, &gmask, &bmask, &amask);
+
+	SDL_Surface* src = SDL_CreateRGBSurface(0, SRC_SIZE, SRC_SIZE, bpp, rmask, gmask, bmask, amask);
+	SDL_Surface* dest = SDL_CreateRGBSurface(0, DEST_SIZE, DEST_SIZE, bpp, rmask, gmask, bmask, amask);
+
+	if (!src || !dest) {
+		results.push_back(std::string("Unable to create benchmark surfaces: ") + SDL_GetError());
+		if (src) SDL_FreeSurface(src);
+		if (dest) SDL_FreeSurface(dest);
+		return;
+	}
+
+	// a round sprite: opaque center, soft edge, transparent corners
+	for (int y = 0; y < SRC_SIZE; ++y) {
+		Uint32* p = reinterpret_cast<Uint32*>(static_cast<Uint8*>(src->pixels) + y * src->pitch);
+		for (int x = 0; x < SRC_SIZE; ++x) {
+			int dx = x - SRC_SIZE/2;
+			int dy = y - SRC_SIZE/2;
+			int dist = static_cast<int>(sqrtf(static_cast<float>(dx*dx + dy*dy)));
+			Uint32 a = static_cast<Uint32>(std::max(0, std::min(255, (SRC_SIZE/2 - dist) * 32)));
+			p[x] = (a << 24) | (static_cast<Uint32>(x * 4) << 16) | (static_cast<Uint32>(y * 4) << 8) | 0x80;
+		}
+	}
+	SDL_FillRect(dest, NULL, SDL_MapRGBA(dest->format, 40, 60, 80, 255));
+
+	// SDL_BlitSurface works on straight alpha, our blitter on premultiplied alpha
+	SDL_Surface* src_premultiplied = SDL_ConvertSurfaceFormat(src, SDL_PIXELFORMAT_ARGB8888, 0);
+	premultiplySurface(src_premultiplied);
+
+	const int MODE_COUNT = 3;
+	const char* mode_names[MODE_COUNT] = {"normal", "modulated", "additive"};
+	BlitParams modes[MODE_COUNT];
+	modes[1].color_mod_r = 255;
+	modes[1].color_mod_g = 64;
+	modes[1].color_mod_b = 64;
+	modes[1].alpha_mod = 128;
+	modes[2].blend_mode = BLIT_BLEND_ADD;
+
+	const double freq = static_cast<double>(SDL_GetPerformanceFrequency());
+	const int steps = (DEST_SIZE - SRC_SIZE) / 8;
+
+	for (int m = 0; m < MODE_COUNT; ++m) {
+		SDL_Rect dest_rect;
+
+		Uint64 start = SDL_GetPerformanceCounter();
+		for (int i = 0; i < ITERATIONS; ++i) {
+			dest_rect.x = (i % steps) * 8;
+			dest_rect.y = ((i / steps) % steps) * 8;
+			blitSurfaceSDL(src, NULL, dest, &dest_rect, modes[m]);
+		}
+		double sdl_time = static_cast<double>(SDL_GetPerformanceCounter() - start) / freq;
+
+		BlitParams params = modes[m];
+		params.premultiplied = true;
+		start = SDL_GetPerformanceCounter();
+		for (int i = 0; i < ITERATIONS; ++i) {
+			dest_rect.x = (i % steps) * 8;
+			dest_rect.y = ((i / steps) % steps) * 8;
+			blitSurface(src_premultiplied, NULL, dest, &dest_rect, params);
+		}
+		double blitter_time = static_cast<double>(SDL_GetPerformanceCounter() - start) / freq;
+
+		std::stringstream ss;
+		ss << std::fixed << std::setprecision(2);
+		ss << mode_names[m] << ": SDL_BlitSurface " << (sdl_time * 1000000.0 / ITERATIONS) << "us, ";
+		ss << getBlitterName() << " " << (blitter_time * 1000000.0 / ITERATIONS) << "us";
+		if (blitter_time > 0)
+			ss << " (x" << (sdl_time / blitter_time) << ")";
+		results.push_back(ss.str());
+	}
+
+	SDL_FreeSurface(src_premultiplied);
+	SDL_FreeSurface(src);
+	SDL_FreeSurface(dest);
+}
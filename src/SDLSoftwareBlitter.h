@@ -0,0 +1,72 @@
+/*
+Copyright © 2016 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+/**
+ * SDLSoftwareBlitter
+ *
+ * ARGB8888 blitter used by SDLSoftwareRenderDevice. SDL_BlitSurface leaves its
+ * fast paths as soon as a color or alpha mod is set on the source surface, which
+ * is the case for every sprite tinted by EffectManager. These kernels handle
+ * normal, additive and modulated blends, using SSE2 or NEON when available.
+ *
+ * Images loaded by SDLSoftwareRenderDevice are stored with premultiplied alpha
+ * (see premultiplySurface()). Sources with straight alpha, such as rendered text,
+ * are premultiplied on the fly.
+ */
+
+#ifndef SDL_SOFTWARE_BLITTER_H
+#define SDL_SOFTWARE_BLITTER_H
+
+#include "CommonIncludes.h"
+
+enum {
+	BLIT_BLEND_NORMAL = 0,
+	BLIT_BLEND_ADD = 1
+};
+
+class BlitParams {
+public:
+	int blend_mode;
+	Uint8 color_mod_r;
+	Uint8 color_mod_g;
+	Uint8 color_mod_b;
+	Uint8 alpha_mod;
+	bool premultiplied; // the source surface has premultiplied alpha
+
+	BlitParams();
+};
+
+// Blit src to dest like SDL_BlitSurface(), including clipping
+// Surfaces that are not ARGB8888 are passed on to SDL_BlitSurface()
+int blitSurface(SDL_Surface* src, const SDL_Rect* src_rect, SDL_Surface* dest, SDL_Rect* dest_rect, const BlitParams& params);
+
+// The two halves of blitSurface(), for callers that do their own clipping and locking (ARGB8888 only)
+bool clipBlit(const SDL_Surface* src, SDL_Rect& src_rect, const SDL_Rect& clip, SDL_Rect& dest_rect);
+void blitClipped(const SDL_Surface* src, const SDL_Rect& src_rect, SDL_Surface* dest, const SDL_Rect& dest_rect, const BlitParams& params);
+
+bool isARGB8888(const SDL_Surface* surface);
+
+void premultiplySurface(SDL_Surface* surface);
+Uint8 premultiplyChannel(Uint8 c, Uint8 a);
+
+// Name of the kernel set compiled in ("SSE2", "NEON" or "scalar")
+const char* getBlitterName();
+
+// Times blitSurface() against SDL_BlitSurface() and appends one line per blend mode to results
+void benchmarkBlitter(std::vector<std::string>& results);
+
+#endif
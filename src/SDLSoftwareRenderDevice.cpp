@@ -30,11 +30,14 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include "Settings.h"
 
 #include "SDLSoftwareRenderDevice.h"
+#include "SDLSoftwareBlitter.h"
+#include "SDLSoftwareTileRenderer.h"
 #include "SDLFontEngine.h"
 
 SDLSoftwareImage::SDLSoftwareImage(RenderDevice *_device)
 	: Image(_device)
-	, surface(NULL) {
+	, surface(NULL)
+	, premultiplied(false) {
 }
 
 SDLSoftwareImage::~SDLSoftwareImage() {
@@ -53,6 +56,8 @@ int SDLSoftwareImage::getHeight() const {
 void SDLSoftwareImage::fillWithColor(const Color& color) {
 	if (!surface) return;
 
+	flushDevice();
+
 	SDL_FillRect(surface, NULL, MapRGBA(color.r, color.g, color.b, color.a));
 }
 
@@ -63,18 +68,11 @@ void SDLSoftwareImage::fillWithColor(const Color& color) {
  * Source: SDL Documentation
  * http://www.libsdl.org/docs/html/guidevideo.html
  */
-void SDLSoftwareImage::drawPixel(int x, int y, const Color& color) {
-	if (!surface) return;
-
-	Uint32 pixel = MapRGBA(color.r, color.g, color.b, color.a);
-
+static void setSurfacePixel(SDL_Surface *surface, int x, int y, Uint32 pixel) {
 	int bpp = surface->format->BytesPerPixel;
 	/* Here p is the address to the pixel we want to set */
 	Uint8 *p = (Uint8 *)surface->pixels + y * surface->pitch + x * bpp;
 
-	if (SDL_MUSTLOCK(surface)) {
-		SDL_LockSurface(surface);
-	}
 	switch(bpp) {
 		case 1:
 			*p = static_cast<Uint8>(pixel);
@@ -100,6 +98,51 @@ void SDLSoftwareImage::drawPixel(int x, int y, const Color& color) {
 			*(Uint32 *)p = pixel;
 			break;
 	}
+}
+
+void SDLSoftwareImage::drawPixel(int x, int y, const Color& color) {
+	if (!surface) return;
+
+	flushDevice();
+
+	Uint32 pixel = MapRGBA(color.r, color.g, color.b, color.a);
+
+	if (SDL_MUSTLOCK(surface)) {
+		SDL_LockSurface(surface);
+	}
+	setSurfacePixel(surface, x, y, pixel);
+	if (SDL_MUSTLOCK(surface)) {
+		SDL_UnlockSurface(surface);
+	}
+}
+
+/*
+ * Copy a block of pixels (row by row, area.w * area.h) to the image
+ * The surface is only locked once for the whole block
+ */
+void SDLSoftwareImage::writePixels(const Rect& area, const std::vector<Color>& pixels) {
+	if (!surface || area.w <= 0 || area.h <= 0) return;
+	if (pixels.size() < static_cast<size_t>(area.w * area.h)) return;
+
+	flushDevice();
+
+	if (SDL_MUSTLOCK(surface)) {
+		SDL_LockSurface(surface);
+	}
+
+	for (int j = 0; j < area.h; ++j) {
+		const int y = area.y + j;
+		if (y < 0 || y >= surface->h) continue;
+
+		for (int i = 0; i < area.w; ++i) {
+			const int x = area.x + i;
+			if (x < 0 || x >= surface->w) continue;
+
+			const Color& color = pixels[j * area.w + i];
+			setSurfacePixel(surface, x, y, MapRGBA(color.r, color.g, color.b, color.a));
+		}
+	}
+
 	if (SDL_MUSTLOCK(surface)) {
 		SDL_UnlockSurface(surface);
 	}
@@ -107,9 +150,19 @@ void SDLSoftwareImage::drawPixel(int x, int y, const Color& color) {
 
 Uint32 SDLSoftwareImage::MapRGBA(Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
 	if (!surface) return 0;
+	if (premultiplied)
+		return SDL_MapRGBA(surface->format, premultiplyChannel(r, a), premultiplyChannel(g, a), premultiplyChannel(b, a), a);
 	return SDL_MapRGBA(surface->format, r, g, b, a);
 }
 
+/**
+ * Pending screen blits may still read from this image, so they have to be drawn before it changes
+ */
+void SDLSoftwareImage::flushDevice() {
+	if (device)
+		static_cast<SDLSoftwareRenderDevice *>(device)->flushTiles();
+}
+
 /**
  * Resizes an image
  * Deletes the original image and returns a pointer to the resized version
@@ -129,7 +182,11 @@ Image* SDLSoftwareImage::resize(int width, int height) {
 											   surface->format->Amask);
 
 		if (scaled->surface) {
+			// copy the pixels as they are, instead of blending them onto the blank surface
+			SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
 			SDL_BlitScaled(surface, NULL, scaled->surface, NULL);
+			SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_BLEND);
+			scaled->premultiplied = premultiplied;
 
 			// delete the old image and return the new one
 			this->unref();
@@ -149,7 +206,8 @@ SDLSoftwareRenderDevice::SDLSoftwareRenderDevice()
 	, renderer(NULL)
 	, texture(NULL)
 	, titlebar_icon(NULL)
-	, title(NULL) {
+	, title(NULL)
+	, tile_renderer(NULL) {
 	logInfo("Using Render Device: SDLSoftwareRenderDevice (software, SDL 2)");
 
 	fullscreen = FULLSCREEN;
@@ -269,6 +327,7 @@ int SDLSoftwareRenderDevice::createContext(bool allow_fallback) {
 		}
 
 		windowResize();
+		createTileRenderer();
 
 		// update title bar text and icon
 		updateTitleBar();
@@ -292,22 +351,26 @@ int SDLSoftwareRenderDevice::createContext(bool allow_fallback) {
 }
 
 int SDLSoftwareRenderDevice::render(Renderable& r, Rect& dest) {
+	stats.draws++;
 	SDL_Rect src = r.src;
 	SDL_Rect _dest = dest;
 
-	SDL_Surface *surface = static_cast<SDLSoftwareImage *>(r.image)->surface;
+	SDLSoftwareImage *image = static_cast<SDLSoftwareImage *>(r.image);
 
-	if (r.blend_mode == RENDERABLE_BLEND_ADD) {
-		SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_ADD);
-	}
-	else { // RENDERABLE_BLEND_NORMAL
-		SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_BLEND);
-	}
+	BlitParams params;
+	params.blend_mode = (r.blend_mode == RENDERABLE_BLEND_ADD ? BLIT_BLEND_ADD : BLIT_BLEND_NORMAL);
+	params.color_mod_r = r.color_mod.r;
+	params.color_mod_g = r.color_mod.g;
+	params.color_mod_b = r.color_mod.b;
+	params.alpha_mod = r.alpha_mod;
+	params.premultiplied = image->premultiplied;
 
-	SDL_SetSurfaceColorMod(surface, r.color_mod.r, r.color_mod.g, r.color_mod.b);
-	SDL_SetSurfaceAlphaMod(surface, r.alpha_mod);
+	if (tile_renderer) {
+		tile_renderer->add(image, image->surface, src, _dest, params, screen);
+		return 0;
+	}
 
-	return SDL_BlitSurface(surface, &src, screen, &_dest);
+	return blitSurface(image->surface, &src, screen, &_dest, params);
 }
 
 int SDLSoftwareRenderDevice::render(Sprite *r) {
@@ -319,19 +382,37 @@ int SDLSoftwareRenderDevice::render(Sprite *r) {
 		return -1;
 	}
 
+	stats.draws++;
+
 	SDL_Rect src = m_clip;
 	SDL_Rect dest = m_dest;
-	return SDL_BlitSurface(static_cast<SDLSoftwareImage *>(r->getGraphics())->surface, &src, screen, &dest);
+
+	SDLSoftwareImage *image = static_cast<SDLSoftwareImage *>(r->getGraphics());
+
+	BlitParams params;
+	params.premultiplied = image->premultiplied;
+
+	if (tile_renderer) {
+		tile_renderer->add(image, image->surface, src, dest, params, screen);
+		return 0;
+	}
+
+	return blitSurface(image->surface, &src, screen, &dest, params);
 }
 
 int SDLSoftwareRenderDevice::renderToImage(Image* src_image, Rect& src, Image* dest_image, Rect& dest) {
 	if (!src_image || !dest_image) return -1;
 
+	flushTiles();
+
 	SDL_Rect _src = src;
 	SDL_Rect _dest = dest;
 
-	return SDL_BlitSurface(static_cast<SDLSoftwareImage *>(src_image)->surface, &_src,
-						   static_cast<SDLSoftwareImage *>(dest_image)->surface, &_dest);
+	BlitParams params;
+	params.premultiplied = static_cast<SDLSoftwareImage *>(src_image)->premultiplied;
+
+	return blitSurface(static_cast<SDLSoftwareImage *>(src_image)->surface, &_src,
+					   static_cast<SDLSoftwareImage *>(dest_image)->surface, &_dest, params);
 }
 
 int SDLSoftwareRenderDevice::renderText(
@@ -349,7 +430,14 @@ int SDLSoftwareRenderDevice::renderText(
 		return -1;
 
 	SDL_Rect _dest = dest;
-	ret = SDL_BlitSurface(surface, NULL, screen, &_dest);
+
+	if (tile_renderer) {
+		// the tile renderer frees the surface once it has been drawn
+		tile_renderer->addSurface(surface, _dest, BlitParams(), screen);
+		return 0;
+	}
+
+	ret = blitSurface(surface, NULL, screen, &_dest, BlitParams());
 
 	SDL_FreeSurface(surface);
 
@@ -375,6 +463,8 @@ Image* SDLSoftwareRenderDevice::renderTextToImage(FontStyle* font_style, const s
 }
 
 void SDLSoftwareRenderDevice::drawPixel(int x, int y, const Color& color) {
+	flushTiles();
+
 	Uint32 pixel = MapRGBA(color.r, color.g, color.b, color.a);
 
 	int bpp = screen->format->BytesPerPixel;
@@ -456,23 +546,33 @@ void SDLSoftwareRenderDevice::drawRectangle(const Point& p0, const Point& p1, co
 }
 
 void SDLSoftwareRenderDevice::blankScreen() {
+	flushTiles();
 	SDL_FillRect(screen, NULL, 0);
 	return;
 }
 
 void SDLSoftwareRenderDevice::commitFrame() {
+	flushTiles();
+
 	SDL_UpdateTexture(texture, NULL, screen->pixels, screen->pitch);
 	SDL_RenderClear(renderer);
 	SDL_RenderCopy(renderer, texture, NULL, NULL);
 	SDL_RenderPresent(renderer);
 	inpt->window_resized = false;
 
+	frame_stats = stats;
+	stats.clear();
+
 	return;
 }
 
 void SDLSoftwareRenderDevice::destroyContext() {
 	resetGamma();
 
+	// drops any pending blits, along with their image references
+	delete tile_renderer;
+	tile_renderer = NULL;
+
 	// we need to free all loaded graphics as they may be tied to the current context
 	RenderDevice::cacheRemoveAll();
 	reload_graphics = true;
@@ -544,6 +644,9 @@ Image *SDLSoftwareRenderDevice::createImage(int width, int height) {
 	image->surface = SDL_ConvertSurfaceFormat(cleanup, SDL_PIXELFORMAT_ARGB8888, 0);
 	SDL_FreeSurface(cleanup);
 
+	// the surface is blank, so it is premultiplied already
+	image->premultiplied = true;
+
 	return image;
 }
 
@@ -579,7 +682,7 @@ Image *SDLSoftwareRenderDevice::loadImage(const std::string& filename, const std
 	// load image
 	SDLSoftwareImage *image;
 	image = NULL;
-	SDL_Surface *cleanup = IMG_Load(mods->locate(filename).c_str());
+	SDL_Surface *cleanup = image_cache->load(mods->locate(filename));
 	if(!cleanup) {
 		if (!errormessage.empty())
 			logError("SDLSoftwareRenderDevice: [%s] %s: %s", filename.c_str(), errormessage.c_str(), IMG_GetError());
@@ -592,6 +695,9 @@ Image *SDLSoftwareRenderDevice::loadImage(const std::string& filename, const std
 		image = new SDLSoftwareImage(this);
 		image->surface = SDL_ConvertSurfaceFormat(cleanup, SDL_PIXELFORMAT_ARGB8888, 0);
 		SDL_FreeSurface(cleanup);
+
+		premultiplySurface(image->surface);
+		image->premultiplied = true;
 	}
 
 	// store image to cache
@@ -640,6 +746,8 @@ void SDLSoftwareRenderDevice::windowResize() {
 
 	SDL_RenderSetLogicalSize(renderer, VIEW_W, VIEW_H);
 
+	flushTiles();
+
 	if (texture) SDL_DestroyTexture(texture);
 	if (screen) SDL_FreeSurface(screen);
 
@@ -651,3 +759,33 @@ void SDLSoftwareRenderDevice::windowResize() {
 
 	updateScreenVars();
 }
+
+/**
+ * Start or stop the binned renderer, depending on RENDER_THREADS
+ */
+void SDLSoftwareRenderDevice::createTileRenderer() {
+	// the tiles are drawn by job_system, which can't lend more threads than it has
+	int thread_count = job_system->getThreadCount();
+	if (RENDER_THREADS > 0)
+		thread_count = std::min(RENDER_THREADS, thread_count);
+
+	if (tile_renderer && tile_renderer->getThreadCount() == thread_count)
+		return;
+
+	flushTiles();
+	delete tile_renderer;
+	tile_renderer = NULL;
+
+	if (thread_count > 1) {
+		tile_renderer = new SDLSoftwareTileRenderer(thread_count);
+		logInfo("SDLSoftwareRenderDevice: Drawing with %d threads.", tile_renderer->getThreadCount());
+	}
+}
+
+/**
+ * Draw all blits recorded by the tile renderer
+ */
+void SDLSoftwareRenderDevice::flushTiles() {
+	if (tile_renderer && screen)
+		tile_renderer->flush(screen);
+}
@@ -23,6 +23,8 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 
 #include "RenderDevice.h"
 
+class SDLSoftwareTileRenderer;
+
 /** Provide rendering device using SDL_BlitSurface backend.
  *
  * Provide an SDL_BlitSurface implementation for renderning a Renderable to
@@ -49,12 +51,15 @@ public:
 
 	void fillWithColor(const Color& color);
 	void drawPixel(int x, int y, const Color& color);
+	void writePixels(const Rect& area, const std::vector<Color>& pixels);
 	Image* resize(int width, int height);
 
 	SDL_Surface *surface;
+	bool premultiplied; // see premultiplySurface()
 
 private:
 	Uint32 MapRGBA(Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+	void flushDevice();
 };
 
 class SDLSoftwareRenderDevice : public RenderDevice {
@@ -84,10 +89,14 @@ public:
 	Image* loadImage(const std::string& filename,
 					 const std::string& errormessage = "Couldn't load image",
 					 bool IfNotFoundExit = false);
+
+	void flushTiles();
+
 private:
 	Uint32 MapRGBA(Uint8 r, Uint8 g, Uint8 b, Uint8 a);
 	void drawLine(int x0, int y0, int x1, int y1, const Color& color);
 	void setSDL_RGBA(Uint32 *rmask, Uint32 *gmask, Uint32 *bmask, Uint32 *amask);
+	void createTileRenderer();
 
 	SDL_Surface* screen;
 	SDL_Window* window;
@@ -95,6 +104,7 @@ private:
 	SDL_Texture* texture;
 	SDL_Surface* titlebar_icon;
 	char* title;
+	SDLSoftwareTileRenderer* tile_renderer; // NULL unless RENDER_THREADS and job_system allow more than one thread
 };
 
 #endif // SDLSOFTWARERENDERDEVICE_H
@@ -0,0 +1,206 @@
+/*
+Copyright © 2016 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+#include "SDLSoftwareTileRenderer.h"
+#include "RenderDevice.h"
+#include "SharedResources.h"
+#include "Utils.h"
+
+void TileRenderJob::run() {
+	renderer->renderTiles();
+}
+
+// number of tiles per thread, so that threads with cheap tiles can pick up more work
+const int TILES_PER_THREAD = 4;
+const int MIN_TILE_HEIGHT = 16;
+
+/**
+ * thread_count includes the main thread, which draws tiles too. The other threads
+ * are borrowed from job_system, so there is no point in asking for more than it has.
+ */
+SDLSoftwareTileRenderer::SDLSoftwareTileRenderer(int thread_count)
+	: target(NULL)
+	, tile_height(MIN_TILE_HEIGHT)
+	, tile_count(0) {
+	SDL_AtomicSet(&next_tile, 0);
+
+	jobs.resize(std::max(thread_count - 1, 0));
+	for (size_t i = 0; i < jobs.size(); ++i) {
+		jobs[i].renderer = this;
+	}
+}
+
+SDLSoftwareTileRenderer::~SDLSoftwareTileRenderer() {
+	release();
+}
+
+int SDLSoftwareTileRenderer::getThreadCount() const {
+	return static_cast<int>(jobs.size()) + 1;
+}
+
+bool SDLSoftwareTileRenderer::empty() const {
+	return blits.empty();
+}
+
+/**
+ * Add a blit to the command list
+ * The blit is clipped to the screen right away, so that it can be binned on flush
+ */
+bool SDLSoftwareTileRenderer::record(Image* image, SDL_Surface* surface, const SDL_Rect& src, const SDL_Rect& dest, const BlitParams& params, const SDL_Surface* screen) {
+	SoftwareBlit blit;
+	blit.surface = surface;
+	blit.image = image;
+	blit.src = src;
+	blit.dest = dest;
+	blit.params = params;
+
+	if (!clipBlit(surface, blit.src, screen->clip_rect, blit.dest))
+		return false;
+
+	blits.push_back(blit);
+	return true;
+}
+
+/**
+ * Record a blit of an image to the screen
+ */
+void SDLSoftwareTileRenderer::add(Image* image, SDL_Surface* surface, const SDL_Rect& src, const SDL_Rect& dest, const BlitParams& params, const SDL_Surface* screen) {
+	if (!surface || !screen)
+		return;
+
+	if (isARGB8888(surface)) {
+		if (record(image, surface, src, dest, params, screen) && image)
+			image->ref();
+	}
+	else {
+		// other formats would have to go through SDL_BlitSurface(), which can't be clipped per tile
+		SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+		if (converted && !record(NULL, converted, src, dest, params, screen))
+			SDL_FreeSurface(converted);
+	}
+}
+
+/**
+ * Record a blit of a temporary surface to the screen
+ * The renderer takes ownership of surface
+ */
+void SDLSoftwareTileRenderer::addSurface(SDL_Surface* surface, const SDL_Rect& dest, const BlitParams& params, const SDL_Surface* screen) {
+	if (!surface || !screen)
+		return;
+
+	SDL_Rect src;
+	src.x = src.y = 0;
+	src.w = surface->w;
+	src.h = surface->h;
+
+	if (isARGB8888(surface)) {
+		if (!record(NULL, surface, src, dest, params, screen))
+			SDL_FreeSurface(surface);
+	}
+	else {
+		add(NULL, surface, src, dest, params, screen);
+		SDL_FreeSurface(surface);
+	}
+}
+
+void SDLSoftwareTileRenderer::flush(SDL_Surface* screen) {
+	if (blits.empty())
+		return;
+
+	target = screen;
+
+	int thread_count = getThreadCount();
+	tile_height = std::max(MIN_TILE_HEIGHT, (target->h + thread_count * TILES_PER_THREAD - 1) / (thread_count * TILES_PER_THREAD));
+	tile_count = (target->h + tile_height - 1) / tile_height;
+
+	if (bins.size() < static_cast<size_t>(tile_count))
+		bins.resize(tile_count);
+	for (int i = 0; i < tile_count; ++i) {
+		bins[i].clear();
+	}
+
+	for (size_t i = 0; i < blits.size(); ++i) {
+		const SDL_Rect& dest = blits[i].dest;
+		int first = std::max(0, dest.y / tile_height);
+		int last = std::min(tile_count - 1, (dest.y + dest.h - 1) / tile_height);
+		for (int tile = first; tile <= last; ++tile) {
+			bins[tile].push_back(i);
+		}
+	}
+
+	if (SDL_MUSTLOCK(target))
+		SDL_LockSurface(target);
+
+	SDL_AtomicSet(&next_tile, 0);
+
+	JobCounter drawn;
+	for (size_t i = 0; i < jobs.size(); ++i) {
+		job_system->run(&jobs[i], &drawn);
+	}
+
+	renderTiles();
+
+	// all tiles are taken by now, but other threads might still be drawing theirs
+	job_system->wait(&drawn);
+
+	if (SDL_MUSTLOCK(target))
+		SDL_UnlockSurface(target);
+
+	target = NULL;
+	release();
+}
+
+/**
+ * Draw tiles until there are none left
+ * Called by the render jobs and the main thread at the same time
+ */
+void SDLSoftwareTileRenderer::renderTiles() {
+	int tile = SDL_AtomicAdd(&next_tile, 1);
+
+	while (tile < tile_count) {
+		SDL_Rect clip;
+		clip.x = 0;
+		clip.y = tile * tile_height;
+		clip.w = target->w;
+		clip.h = tile_height;
+
+		const std::vector<size_t>& bin = bins[tile];
+		for (size_t i = 0; i < bin.size(); ++i) {
+			const SoftwareBlit& blit = blits[bin[i]];
+			SDL_Rect src = blit.src;
+			SDL_Rect dest = blit.dest;
+
+			if (clipBlit(blit.surface, src, clip, dest))
+				blitClipped(blit.surface, src, target, dest, blit.params);
+		}
+
+		tile = SDL_AtomicAdd(&next_tile, 1);
+	}
+}
+
+/**
+ * Drop the recorded blits, along with their image references and temporary surfaces
+ */
+void SDLSoftwareTileRenderer::release() {
+	for (size_t i = 0; i < blits.size(); ++i) {
+		if (blits[i].image)
+			blits[i].image->unref();
+		else
+			SDL_FreeSurface(blits[i].surface);
+	}
+	blits.clear();
+}
@@ -0,0 +1,91 @@
+/*
+Copyright © 2016 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+/**
+ * class SDLSoftwareTileRenderer
+ *
+ * Binned renderer mode of SDLSoftwareRenderDevice. Instead of blitting right
+ * away, the screen blits of a frame are recorded in a command list. On flush(),
+ * the screen is split into horizontal tiles, each command is binned into the
+ * tiles it overlaps, and the tiles are drawn by jobs on the shared JobSystem
+ * together with the main thread. Every tile runs its commands in the order they
+ * were recorded, so the result is the same as drawing them one after another on
+ * the main thread.
+ *
+ * Recorded images are referenced until the commands are flushed. Anything that
+ * changes the pixels of an image or the screen outside of a recorded blit has to
+ * flush the pending commands first.
+ */
+
+#ifndef SDL_SOFTWARE_TILE_RENDERER_H
+#define SDL_SOFTWARE_TILE_RENDERER_H
+
+#include "CommonIncludes.h"
+#include "JobSystem.h"
+#include "SDLSoftwareBlitter.h"
+
+class Image;
+class SDLSoftwareTileRenderer;
+
+class SoftwareBlit {
+public:
+	SDL_Surface* surface;
+	Image* image; // holds a reference to the image of surface, or NULL if surface is owned by the blit
+	SDL_Rect src;
+	SDL_Rect dest;
+	BlitParams params;
+};
+
+/**
+ * Draws tiles until none are left, see SDLSoftwareTileRenderer::flush()
+ */
+class TileRenderJob : public Job {
+public:
+	SDLSoftwareTileRenderer* renderer;
+
+	void run();
+};
+
+class SDLSoftwareTileRenderer {
+private:
+	friend class TileRenderJob;
+
+	bool record(Image* image, SDL_Surface* surface, const SDL_Rect& src, const SDL_Rect& dest, const BlitParams& params, const SDL_Surface* screen);
+	void renderTiles();
+	void release();
+
+	std::vector<SoftwareBlit> blits;
+	std::vector< std::vector<size_t> > bins; // blit indices per tile
+	std::vector<TileRenderJob> jobs;
+	SDL_atomic_t next_tile;
+	SDL_Surface* target;
+	int tile_height;
+	int tile_count;
+
+public:
+	explicit SDLSoftwareTileRenderer(int thread_count);
+	~SDLSoftwareTileRenderer();
+
+	int getThreadCount() const;
+	bool empty() const;
+
+	void add(Image* image, SDL_Surface* surface, const SDL_Rect& src, const SDL_Rect& dest, const BlitParams& params, const SDL_Surface* screen);
+	void addSurface(SDL_Surface* surface, const SDL_Rect& dest, const BlitParams& params, const SDL_Surface* screen);
+	void flush(SDL_Surface* screen);
+};
+
+#endif
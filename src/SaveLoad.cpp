@@ -40,6 +40,7 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include "MenuInventory.h"
 #include "MenuLog.h"
 #include "MenuManager.h"
+#include "MenuMiniMap.h"
 #include "MenuStash.h"
 #include "MenuTalker.h"
 #include "Settings.h"
@@ -163,6 +164,13 @@ void SaveLoad::saveGame() {
 			pc->stats.powers_list = pc->charmed_stats->powers_list;
 		}
 
+		// explored mini map areas
+		std::vector<std::string> explored;
+		menu->mini->getExplored(explored);
+		for (size_t i = 0; i < explored.size(); ++i) {
+			outfile << "explored=" << explored[i] << "\n";
+		}
+
 		// campaign data
 		outfile << "campaign=";
 		outfile << camp->getAll();
@@ -219,6 +227,8 @@ void SaveLoad::loadGame() {
 	std::stringstream ss;
 	ss << PATH_USER << "saves/" << SAVE_PREFIX << "/" << game_slot << "/avatar.txt";
 
+	menu->mini->clearExplored();
+
 	if (infile.open(path(&ss), false)) {
 		while (infile.next()) {
 			if (infile.key == "name") pc->stats.name = infile.val;
@@ -314,6 +324,7 @@ void SaveLoad::loadGame() {
 						pc->stats.powers_list.push_back(toInt(power));
 				}
 			}
+			else if (infile.key == "explored") menu->mini->setExplored(infile.val);
 			else if (infile.key == "campaign") camp->setAll(infile.val);
 		}
 
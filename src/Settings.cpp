@@ -69,6 +69,7 @@ ConfigEntry config[] = {
 	{ "vsync",             &typeid(VSYNC),              "1",   &VSYNC,              NULL},
 	{ "texture_filter",    &typeid(TEXTURE_FILTER),     "1",   &TEXTURE_FILTER,     "texture filter quality. 0 nearest neighbor (worst), 1 linear (best)"},
 	{ "max_fps",           &typeid(MAX_FRAMES_PER_SEC), "60",  &MAX_FRAMES_PER_SEC, "maximum frames per second. default is 60"},
+	{ "max_render_fps",    &typeid(MAX_RENDER_FPS),     "0",   &MAX_RENDER_FPS,     "maximum rendered frames per second. Game logic runs at max_fps, rendering in between is interpolated. 0 uses the refresh rate of the display"},
 	{ "renderer",          &typeid(RENDER_DEVICE),      "sdl", &RENDER_DEVICE,      "default render device. 'sdl' is the default setting"},
 	{ "enable_joystick",   &typeid(ENABLE_JOYSTICK),    "0",   &ENABLE_JOYSTICK,    "joystick settings."},
 	{ "joystick_device",   &typeid(JOYSTICK_DEVICE),    "0",   &JOYSTICK_DEVICE,    NULL},
@@ -85,7 +86,18 @@ ConfigEntry config[] = {
 	{ "dev_hud",           &typeid(DEV_HUD),            "1",   &DEV_HUD,            "shows some additional information on-screen when developer mode is enabled. 1 enable, 0 disable"},
 	{ "loot_tooltips",     &typeid(LOOT_TOOLTIPS),      "1",   &LOOT_TOOLTIPS,      "always show loot tooltips. 1 enable, 0 disable"},
 	{ "statbar_labels",    &typeid(STATBAR_LABELS),     "0",   &STATBAR_LABELS,     "always show labels on HP/MP/XP bars. 1 enable, 0 disable"},
-	{ "auto_equip",        &typeid(AUTO_EQUIP),         "1",   &AUTO_EQUIP,         "automatically equip items. 1 enable, 0 disable"}
+	{ "auto_equip",        &typeid(AUTO_EQUIP),         "1",   &AUTO_EQUIP,         "automatically equip items. 1 enable, 0 disable"},
+	{ "data_cache",        &typeid(DATA_CACHE),         "1",   &DATA_CACHE,         "cache parsed game data to speed up loading. 1 enable, 0 disable"},
+	{ "max_lights",        &typeid(MAX_LIGHTS),         "32",  &MAX_LIGHTS,         "maximum number of lights drawn per frame (OpenGL renderer only). 0 disables lighting"},
+	{ "lightmap_scale",    &typeid(LIGHTMAP_SCALE),     "0.25", &LIGHTMAP_SCALE,    "resolution of the light map relative to the screen (0.1 - 1.0). Lower is faster"},
+	{ "render_threads",    &typeid(RENDER_THREADS),     "1",   &RENDER_THREADS,     "number of threads used by the software renderer, taken from the job threads. 1 draws on the main thread only, 0 uses all job threads"},
+	{ "texture_atlas",     &typeid(TEXTURE_ATLAS),      "1",   &TEXTURE_ATLAS,      "pack animation sprite-sheets into shared textures. 1 enable, 0 disable"},
+	{ "avatar_cache",      &typeid(AVATAR_CACHE),       "0",   &AVATAR_CACHE,       "number of pre-rendered hero frames to keep, so that equipment layers are drawn as a single sprite. 0 disables the cache"},
+	{ "texture_depth",     &typeid(TEXTURE_DEPTH),      "32",  &TEXTURE_DEPTH,      "bits per pixel of loaded images (OpenGL renderer only). 16 stores them as RGBA4444, or RGB565 if they have no transparency"},
+	{ "texture_half_size", &typeid(TEXTURE_HALF_SIZE),  "0",   &TEXTURE_HALF_SIZE,  "halve the resolution of large loaded images (OpenGL renderer only). 1 enable, 0 disable"},
+	{ "image_cache",       &typeid(IMAGE_CACHE),        "128", &IMAGE_CACHE,        "size limit in megabytes of the decoded images cached on disk to speed up loading. 0 disables the cache"},
+	{ "ai_lod",            &typeid(AI_LOD),             "1",   &AI_LOD,             "run the AI of enemies far away from the hero less often. 1 enable, 0 disable"},
+	{ "job_threads",       &typeid(JOB_THREADS),        "0",   &JOB_THREADS,        "number of threads that run background jobs, like enemy path finding. 1 uses the main thread only, 0 uses one thread per CPU core"}
 };
 const int config_size = sizeof(config) / sizeof(ConfigEntry);
 
@@ -120,6 +132,7 @@ unsigned short ICON_SIZE;
 bool FULLSCREEN;
 unsigned char BITS_PER_PIXEL = 32;
 unsigned short MAX_FRAMES_PER_SEC;
+unsigned short MAX_RENDER_FPS;
 unsigned short VIEW_W = 0;
 unsigned short VIEW_H = 0;
 unsigned short VIEW_W_HALF = 0;
@@ -155,6 +168,19 @@ bool STATBAR_LABELS;
 bool AUTO_EQUIP;
 bool SHOW_HUD = true;
 
+// Performance Settings
+bool DATA_CACHE;
+int MAX_LIGHTS;
+float LIGHTMAP_SCALE;
+int RENDER_THREADS;
+bool TEXTURE_ATLAS;
+int AVATAR_CACHE;
+int TEXTURE_DEPTH;
+bool TEXTURE_HALF_SIZE;
+int IMAGE_CACHE;
+bool AI_LOD;
+int JOB_THREADS;
+
 // Input Settings
 bool MOUSE_MOVE;
 bool ENABLE_JOYSTICK;
@@ -270,7 +296,7 @@ void loadTilesetSettings() {
 	FileParser infile;
 	// load tileset settings from engine config
 	// @CLASS Settings: Tileset config|Description of engine/tileset_config.txt
-	if (infile.open("engine/tileset_config.txt", true, "Unable to open engine/tileset_config.txt! Defaulting to 64x32 isometric tiles.")) {
+	if (infile.openCached("engine/tileset_config.txt", "Unable to open engine/tileset_config.txt! Defaulting to 64x32 isometric tiles.")) {
 		while (infile.next()) {
 			if (infile.key == "tile_size") {
 				// @ATTR tile_size|int, int : Width, Height|The width and height of a tile.
@@ -380,7 +406,7 @@ void loadMiscSettings() {
 
 	FileParser infile;
 	// @CLASS Settings: Misc|Description of engine/misc.txt
-	if (infile.open("engine/misc.txt")) {
+	if (infile.openCached("engine/misc.txt")) {
 		while (infile.next()) {
 			// @ATTR save_hpmp|bool|When saving the game, keep the hero's current HP and MP.
 			if (infile.key == "save_hpmp")
@@ -444,7 +470,7 @@ void loadMiscSettings() {
 	}
 
 	// @CLASS Settings: Resolution|Description of engine/resolutions.txt
-	if (infile.open("engine/resolutions.txt")) {
+	if (infile.openCached("engine/resolutions.txt")) {
 		while (infile.next()) {
 			// @ATTR menu_frame_width|int|Width of frame for New Game, Configuration, etc. menus.
 			if (infile.key == "menu_frame_width")
@@ -508,7 +534,7 @@ void loadMiscSettings() {
 	}
 
 	// @CLASS Settings: Gameplay|Description of engine/gameplay.txt
-	if (infile.open("engine/gameplay.txt")) {
+	if (infile.openCached("engine/gameplay.txt")) {
 		while (infile.next()) {
 			if (infile.key == "enable_playgame") {
 				// @ATTR enable_playgame|bool|Enables the "Play Game" button on the main menu.
@@ -520,7 +546,7 @@ void loadMiscSettings() {
 	}
 
 	// @CLASS Settings: Combat|Description of engine/combat.txt
-	if (infile.open("engine/combat.txt")) {
+	if (infile.openCached("engine/combat.txt")) {
 		while (infile.next()) {
 			if (infile.key == "absorb_percent") {
 				// @ATTR absorb_percent|int, int : Minimum, Maximum|Limits the percentage of damage that can be absorbed.
@@ -571,7 +597,7 @@ void loadMiscSettings() {
 	}
 
 	// @CLASS Settings: Elements|Description of engine/elements.txt
-	if (infile.open("engine/elements.txt")) {
+	if (infile.openCached("engine/elements.txt")) {
 		while (infile.next()) {
 			if (infile.new_section) {
 				if (infile.section == "element") {
@@ -602,7 +628,7 @@ void loadMiscSettings() {
 	}
 
 	// @CLASS Settings: Equip flags|Description of engine/equip_flags.txt
-	if (infile.open("engine/equip_flags.txt")) {
+	if (infile.openCached("engine/equip_flags.txt")) {
 		while (infile.next()) {
 			if (infile.new_section) {
 				if (infile.section == "flag") {
@@ -633,7 +659,7 @@ void loadMiscSettings() {
 	}
 
 	// @CLASS Settings: Primary Stats|Description of engine/primary_stats.txt
-	if (infile.open("engine/primary_stats.txt")) {
+	if (infile.openCached("engine/primary_stats.txt")) {
 		while (infile.next()) {
 			if (infile.new_section) {
 				if (infile.section == "stat") {
@@ -664,7 +690,7 @@ void loadMiscSettings() {
 	}
 
 	// @CLASS Settings: Classes|Description of engine/classes.txt
-	if (infile.open("engine/classes.txt")) {
+	if (infile.openCached("engine/classes.txt")) {
 		while (infile.next()) {
 			if (infile.new_section) {
 				if (infile.section == "class") {
@@ -745,7 +771,7 @@ void loadMiscSettings() {
 	}
 
 	// @CLASS Settings: Death penalty|Description of engine/death_penalty.txt
-	if (infile.open("engine/death_penalty.txt")) {
+	if (infile.openCached("engine/death_penalty.txt")) {
 		while (infile.next()) {
 			// @ATTR enable|bool|Enable the death penalty.
 			if (infile.key == "enable") DEATH_PENALTY = toBool(infile.val);
@@ -766,7 +792,7 @@ void loadMiscSettings() {
 	}
 
 	// @CLASS Settings: Tooltips|Description of engine/tooltips.txt
-	if (infile.open("engine/tooltips.txt")) {
+	if (infile.openCached("engine/tooltips.txt")) {
 		while (infile.next()) {
 			// @ATTR tooltip_offset|int|Offset in pixels from the origin point (usually mouse cursor).
 			if (infile.key == "tooltip_offset")
@@ -788,7 +814,7 @@ void loadMiscSettings() {
 	}
 
 	// @CLASS Settings: Loot|Description of engine/loot.txt
-	if (infile.open("engine/loot.txt")) {
+	if (infile.openCached("engine/loot.txt")) {
 		while (infile.next()) {
 			if (infile.key == "currency_name") {
 				// @ATTR currency_name|string|Define the name of currency in game
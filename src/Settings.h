@@ -90,6 +90,7 @@ extern unsigned short SOUND_VOLUME;
 extern bool FULLSCREEN;
 extern unsigned char BITS_PER_PIXEL;
 extern unsigned short MAX_FRAMES_PER_SEC;
+extern unsigned short MAX_RENDER_FPS;
 extern unsigned short VIEW_W;
 extern unsigned short VIEW_H;
 extern unsigned short VIEW_W_HALF;
@@ -130,6 +131,19 @@ extern bool STATBAR_LABELS;
 extern bool AUTO_EQUIP;
 extern bool SHOW_HUD;
 
+// Performance Settings
+extern bool DATA_CACHE;
+extern int MAX_LIGHTS;
+extern float LIGHTMAP_SCALE;
+extern int RENDER_THREADS;
+extern bool TEXTURE_ATLAS;
+extern int AVATAR_CACHE;
+extern int TEXTURE_DEPTH;
+extern bool TEXTURE_HALF_SIZE;
+extern int IMAGE_CACHE;
+extern bool AI_LOD;
+extern int JOB_THREADS;
+
 // Engine Settings
 extern bool MENUS_PAUSE;
 extern bool SAVE_HPMP;
@@ -32,9 +32,12 @@ Created and destroyed by main.cpp
 AnimationManager *anim;
 CombatText *comb;
 CursorManager *curs;
+DataCache *data_cache;
 FontEngine *font;
 IconManager *icons;
+ImageCache *image_cache;
 InputState *inpt;
+JobSystem *job_system;
 MessageEngine *msg;
 ModManager *mods;
 RenderDevice *render_device;
@@ -34,9 +34,12 @@ Created and destroyed by main.cpp
 #include "AnimationManager.h"
 #include "CombatText.h"
 #include "CursorManager.h"
+#include "DataCache.h"
 #include "FontEngine.h"
 #include "IconManager.h"
+#include "ImageCache.h"
 #include "InputState.h"
+#include "JobSystem.h"
 #include "MessageEngine.h"
 #include "ModManager.h"
 #include "SoundManager.h"
@@ -46,9 +49,12 @@ Created and destroyed by main.cpp
 extern AnimationManager *anim;
 extern CombatText *comb;
 extern CursorManager *curs;
+extern DataCache *data_cache;
 extern FontEngine *font;
 extern IconManager *icons;
+extern ImageCache *image_cache;
 extern InputState *inpt;
+extern JobSystem *job_system;
 extern MessageEngine *msg;
 extern ModManager *mods;
 extern SoundManager *snd;
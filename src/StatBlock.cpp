@@ -37,6 +37,82 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include "UtilsMath.h"
 #include <limits>
 
+// estimates of the heap memory used by containers, for the memory statistics
+static size_t stringMemory(const std::string& s) {
+	// short strings are usually stored inside the string object itself
+	return (s.capacity() < sizeof(std::string) ? 0 : s.capacity() + 1);
+}
+
+template <typename T>
+static size_t vectorMemory(const std::vector<T>& v) {
+	return v.capacity() * sizeof(T);
+}
+
+StatDefinition::StatDefinition()
+	: categories()
+	, per_level(std::vector<int>(STAT_COUNT,0))
+	, loot_table()
+	, loot_count()
+	, defeat_status("")			// enemy only
+	, convert_status("")		// enemy only
+	, quest_loot_requires_status("")	// enemy only
+	, quest_loot_requires_not_status("")		// enemy only
+	, first_defeat_loot(0)		// enemy only
+	, sfx_attack()
+	, sfx_step("")
+	, sfx_hit("")
+	, sfx_die("")
+	, sfx_critdie("")
+	, sfx_block("")
+	, sfx_levelup("") {
+	per_primary.resize(PRIMARY_STATS.size());
+
+	for (size_t i = 0; i < per_primary.size(); ++i) {
+		per_primary[i].resize(STAT_COUNT, 0);
+	}
+}
+
+/**
+ * Approximate memory used by this definition, including its allocations
+ */
+size_t StatDefinition::getMemoryUsage() const {
+	size_t bytes = sizeof(StatDefinition);
+
+	bytes += vectorMemory(categories);
+	for (size_t i = 0; i < categories.size(); ++i) {
+		bytes += stringMemory(categories[i]);
+	}
+
+	bytes += vectorMemory(per_level);
+	bytes += vectorMemory(per_primary);
+	for (size_t i = 0; i < per_primary.size(); ++i) {
+		bytes += vectorMemory(per_primary[i]);
+	}
+
+	bytes += vectorMemory(loot_table);
+	for (size_t i = 0; i < loot_table.size(); ++i) {
+		bytes += stringMemory(loot_table[i].s);
+	}
+
+	bytes += stringMemory(defeat_status);
+	bytes += stringMemory(convert_status);
+	bytes += stringMemory(quest_loot_requires_status);
+	bytes += stringMemory(quest_loot_requires_not_status);
+
+	bytes += vectorMemory(sfx_attack);
+	for (size_t i = 0; i < sfx_attack.size(); ++i) {
+		bytes += stringMemory(sfx_attack[i].first) + stringMemory(sfx_attack[i].second);
+	}
+	bytes += stringMemory(sfx_step);
+	bytes += stringMemory(sfx_hit);
+	bytes += stringMemory(sfx_die);
+	bytes += stringMemory(sfx_critdie);
+	bytes += stringMemory(sfx_block);
+	bytes += stringMemory(sfx_levelup);
+
+	return bytes;
+}
+
 StatBlock::StatBlock()
 	: statsLoaded(false)
 	, alive(true)
@@ -72,7 +148,6 @@ StatBlock::StatBlock()
 	, starting(std::vector<int>(STAT_COUNT,0))
 	, base(std::vector<int>(STAT_COUNT,0))
 	, current(std::vector<int>(STAT_COUNT,0))
-	, per_level(std::vector<int>(STAT_COUNT,0))
 	, character_class("")
 	, character_subclass("")
 	, hp(0)
@@ -127,6 +202,7 @@ StatBlock::StatBlock()
 	, flee_range(0)  // enemy
 	, combat_style(COMBAT_DEFAULT)//enemy
 	, hero_stealth(0)
+	, hero_in_aggro_zone(false)
 	, turn_delay(0)
 	, turn_ticks(0)
 	, in_combat(false)  //enemy only
@@ -143,24 +219,13 @@ StatBlock::StatBlock()
 	, teleport_destination()
 	, currency(0)
 	, death_penalty(false)
-	, defeat_status("")			// enemy only
-	, convert_status("")		// enemy only
-	, quest_loot_requires_status("")	// enemy only
-	, quest_loot_requires_not_status("")		// enemy only
 	, quest_loot_id(0)			// enemy only
-	, first_defeat_loot(0)		// enemy only
+	, loot_dropped(false)		// enemy only
 	, gfx_base("male")
 	, gfx_head("head_short")
 	, gfx_portrait("")
 	, transform_type("")
 	, animations("")
-	, sfx_attack()
-	, sfx_step("")
-	, sfx_hit("")
-	, sfx_die("")
-	, sfx_critdie("")
-	, sfx_block("")
-	, sfx_levelup("")
 	, max_spendable_stat_points(0)
 	, max_points_per_stat(0)
 	, prev_maxhp(0)
@@ -173,11 +238,6 @@ StatBlock::StatBlock()
 {
 	primary.resize(PRIMARY_STATS.size(), 0);
 	primary_additional.resize(PRIMARY_STATS.size(), 0);
-	per_primary.resize(PRIMARY_STATS.size());
-
-	for (size_t i = 0; i < per_primary.size(); ++i) {
-		per_primary[i].resize(STAT_COUNT, 0);
-	}
 }
 
 bool StatBlock::loadCoreStat(FileParser *infile) {
@@ -218,7 +278,7 @@ bool StatBlock::loadCoreStat(FileParser *infile) {
 
 		for (unsigned i=0; i<STAT_COUNT; i++) {
 			if (STAT_KEY[i] == stat) {
-				per_level[i] = value;
+				def.write().per_level[i] = value;
 				return true;
 			}
 		}
@@ -233,7 +293,7 @@ bool StatBlock::loadCoreStat(FileParser *infile) {
 
 		for (unsigned i=0; i<STAT_COUNT; i++) {
 			if (STAT_KEY[i] == stat) {
-				per_primary[prim_stat_index][i] = value;
+				def.write().per_primary[prim_stat_index][i] = value;
 				return true;
 			}
 		}
@@ -268,34 +328,36 @@ bool StatBlock::loadCoreStat(FileParser *infile) {
 bool StatBlock::loadSfxStat(FileParser *infile) {
 	// @CLASS StatBlock: Sound effects|Description of heroes in engine/avatar/ and enemies in enemies/
 
+	StatDefinition& definition = def.write();
+
 	// @ATTR sfx_attack|predefined_string, filename : Animation name, Sound file|Filename of sound effect for the specified attack animation.
 	if (infile->key == "sfx_attack") {
 		std::string anim_name = popFirstString(infile->val);
 		std::string filename = popFirstString(infile->val);
 
 		bool found_anim_name = false;
-		for (size_t i = 0; i < sfx_attack.size(); ++i) {
-			if (anim_name == sfx_attack[i].first) {
-				sfx_attack[i].second = filename;
+		for (size_t i = 0; i < definition.sfx_attack.size(); ++i) {
+			if (anim_name == definition.sfx_attack[i].first) {
+				definition.sfx_attack[i].second = filename;
 				found_anim_name = true;
 				break;
 			}
 		}
 
 		if (!found_anim_name) {
-			sfx_attack.push_back(std::pair<std::string, std::string>(anim_name, filename));
+			definition.sfx_attack.push_back(std::pair<std::string, std::string>(anim_name, filename));
 		}
 	}
 	// @ATTR sfx_hit|filename|Filename of sound effect for being hit.
-	else if (infile->key == "sfx_hit") sfx_hit = infile->val;
+	else if (infile->key == "sfx_hit") definition.sfx_hit = infile->val;
 	// @ATTR sfx_die|filename|Filename of sound effect for dying.
-	else if (infile->key == "sfx_die") sfx_die = infile->val;
+	else if (infile->key == "sfx_die") definition.sfx_die = infile->val;
 	// @ATTR sfx_critdie|filename|Filename of sound effect for dying to a critical hit.
-	else if (infile->key == "sfx_critdie") sfx_critdie = infile->val;
+	else if (infile->key == "sfx_critdie") definition.sfx_critdie = infile->val;
 	// @ATTR sfx_block|filename|Filename of sound effect for blocking an incoming hit.
-	else if (infile->key == "sfx_block") sfx_block = infile->val;
+	else if (infile->key == "sfx_block") definition.sfx_block = infile->val;
 	// @ATTR sfx_levelup|filename|Filename of sound effect for leveling up.
-	else if (infile->key == "sfx_levelup") sfx_levelup = infile->val;
+	else if (infile->key == "sfx_levelup") definition.sfx_levelup = infile->val;
 	else return false;
 
 	return true;
@@ -307,9 +369,11 @@ bool StatBlock::loadSfxStat(FileParser *infile) {
 void StatBlock::load(const std::string& filename) {
 	// @CLASS StatBlock: Enemies|Description of enemies in enemies/
 	FileParser infile;
-	if (!infile.open(filename))
+	if (!infile.openCached(filename))
 		return;
 
+	StatDefinition& definition = def.write();
+
 	bool clear_loot = true;
 	bool flee_range_defined = false;
 
@@ -343,32 +407,32 @@ void StatBlock::load(const std::string& filename) {
 			// loot=[id],[percent_chance],[count_min],[count_max]
 
 			if (clear_loot) {
-				loot_table.clear();
+				definition.loot_table.clear();
 				clear_loot = false;
 			}
 
-			loot_table.push_back(Event_Component());
-			loot->parseLoot(infile.val, &loot_table.back(), &loot_table);
+			definition.loot_table.push_back(Event_Component());
+			loot->parseLoot(infile.val, &definition.loot_table.back(), &definition.loot_table);
 		}
 		else if (infile.key == "loot_count") {
 			// @ATTR loot_count|int, int : Min, Max|Sets the minimum (and optionally, the maximum) amount of loot this creature can drop. Overrides the global drop_max setting.
-			loot_count.x = popFirstInt(infile.val);
-			loot_count.y = popFirstInt(infile.val);
-			if (loot_count.x != 0 || loot_count.y != 0) {
-				loot_count.x = std::max(loot_count.x, 1);
-				loot_count.y = std::max(loot_count.y, loot_count.x);
+			definition.loot_count.x = popFirstInt(infile.val);
+			definition.loot_count.y = popFirstInt(infile.val);
+			if (definition.loot_count.x != 0 || definition.loot_count.y != 0) {
+				definition.loot_count.x = std::max(definition.loot_count.x, 1);
+				definition.loot_count.y = std::max(definition.loot_count.y, definition.loot_count.x);
 			}
 		}
 		// @ATTR defeat_status|string|Campaign status to set upon death.
-		else if (infile.key == "defeat_status") defeat_status = infile.val;
+		else if (infile.key == "defeat_status") definition.defeat_status = infile.val;
 		// @ATTR convert_status|string|Campaign status to set upon being converted to a player ally.
-		else if (infile.key == "convert_status") convert_status = infile.val;
+		else if (infile.key == "convert_status") definition.convert_status = infile.val;
 		// @ATTR first_defeat_loot|item_id|Drops this item upon first death.
-		else if (infile.key == "first_defeat_loot") first_defeat_loot = num;
+		else if (infile.key == "first_defeat_loot") definition.first_defeat_loot = num;
 		// @ATTR quest_loot|string, string, item_id : Required status, Required not status, Item|Drops this item when campaign status is met.
 		else if (infile.key == "quest_loot") {
-			quest_loot_requires_status = popFirstString(infile.val);
-			quest_loot_requires_not_status = popFirstString(infile.val);
+			definition.quest_loot_requires_status = popFirstString(infile.val);
+			definition.quest_loot_requires_not_status = popFirstString(infile.val);
 			quest_loot_id = popFirstInt(infile.val);
 		}
 
@@ -464,10 +528,10 @@ void StatBlock::load(const std::string& filename) {
 
 		else if (infile.key == "categories") {
 			// @ATTR categories|list(string)|Categories that this enemy belongs to.
-			categories.clear();
+			definition.categories.clear();
 			std::string cat;
 			while ((cat = popFirstString(infile.val)) != "") {
-				categories.push_back(cat);
+				definition.categories.push_back(cat);
 			}
 		}
 
@@ -543,9 +607,9 @@ void StatBlock::calcBase() {
 
 	for (int i = 0; i < STAT_COUNT; ++i) {
 		base[i] = starting[i];
-		base[i] += lev0 * per_level[i];
-		for (size_t j = 0; j < per_primary.size(); ++j) {
-			base[i] += std::max(get_primary(j) - 1, 0) * per_primary[j][i];
+		base[i] += lev0 * def->per_level[i];
+		for (size_t j = 0; j < def->per_primary.size(); ++j) {
+			base[i] += std::max(get_primary(j) - 1, 0) * def->per_primary[j][i];
 		}
 	}
 
@@ -816,7 +880,7 @@ void StatBlock::loadHeroStats() {
 			}
 			else if (infile.key == "sfx_step") {
 				// @ATTR sfx_step|string|An id for a set of step sound effects. See items/step_sounds.txt.
-				sfx_step = infile.val;
+				def.write().sfx_step = infile.val;
 			}
 			else if (infile.key == "stat_points_per_level") {
 				// @ATTR stat_points_per_level|int|The amount of stat points awarded each level.
@@ -1032,3 +1096,39 @@ bool StatBlock::checkRequiredSpawns(int req_amount) const {
 
 	return true;
 }
+
+/**
+ * Approximate memory used by this StatBlock, including its allocations
+ * The shared definition is not included, see StatDefinition::getMemoryUsage()
+ */
+size_t StatBlock::getMemoryUsage() const {
+	size_t bytes = sizeof(StatBlock);
+
+	bytes += vectorMemory(xp_table);
+	bytes += vectorMemory(primary);
+	bytes += vectorMemory(primary_additional);
+	bytes += vectorMemory(starting);
+	bytes += vectorMemory(base);
+	bytes += vectorMemory(current);
+	bytes += vectorMemory(vulnerable);
+	bytes += vectorMemory(vulnerable_base);
+	bytes += vectorMemory(powers_list);
+	bytes += vectorMemory(powers_list_items);
+	bytes += vectorMemory(powers_passive);
+	bytes += vectorMemory(powers_ai);
+	bytes += vectorMemory(summons);
+	bytes += vectorMemory(power_filter);
+	bytes += vectorMemory(effects.effect_list);
+	bytes += waypoints.size() * sizeof(FPoint);
+
+	bytes += stringMemory(name);
+	bytes += stringMemory(character_class);
+	bytes += stringMemory(character_subclass);
+	bytes += stringMemory(gfx_base);
+	bytes += stringMemory(gfx_head);
+	bytes += stringMemory(gfx_portrait);
+	bytes += stringMemory(transform_type);
+	bytes += stringMemory(animations);
+
+	return bytes;
+}
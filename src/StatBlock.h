@@ -27,6 +27,7 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #define STAT_BLOCK_H
 
 #include "CommonIncludes.h"
+#include "CopyOnWrite.h"
 #include "EffectManager.h"
 #include "MapCollision.h"
 #include "Stats.h"
@@ -77,6 +78,40 @@ public:
 	{}
 };
 
+/**
+ * The parts of a StatBlock that are read from its file and don't change at
+ * runtime. Creatures of the same type share one copy.
+ */
+class StatDefinition {
+public:
+	StatDefinition();
+	size_t getMemoryUsage() const;
+
+	std::vector<std::string> categories;
+
+	std::vector<int> per_level; // value increases each level after level 1
+	std::vector< std::vector<int> > per_primary;
+
+	std::vector<Event_Component> loot_table;
+	Point loot_count;
+
+	// Campaign event interaction
+	std::string defeat_status;
+	std::string convert_status;
+	std::string quest_loot_requires_status;
+	std::string quest_loot_requires_not_status;
+	int first_defeat_loot;
+
+	// default sounds
+	std::vector<std::pair<std::string, std::string> > sfx_attack;
+	std::string sfx_step;
+	std::string sfx_hit;
+	std::string sfx_die;
+	std::string sfx_critdie;
+	std::string sfx_block;
+	std::string sfx_levelup;
+};
+
 class StatBlock {
 private:
 	bool loadCoreStat(FileParser *infile);
@@ -104,6 +139,10 @@ public:
 	std::string getLongClass();
 	void addXP(int amount);
 	AIPower* getAIPower(AI_POWER ai_type);
+	size_t getMemoryUsage() const;
+
+	// shared with the other creatures of this type
+	CopyOnWrite<StatDefinition> def;
 
 	bool alive;
 	bool corpse; // creature is dead and done animating
@@ -130,8 +169,6 @@ public:
 	bool intangible;
 	bool facing; // does this creature turn to face the hero
 
-	std::vector<std::string> categories;
-
 	std::string name;
 
 	int level;
@@ -149,8 +186,6 @@ public:
 	std::vector<int> starting; // default level 1 values per stat. Read from file and never changes at runtime.
 	std::vector<int> base; // values before any active effects are applied
 	std::vector<int> current; // values after all active effects are applied
-	std::vector<int> per_level; // value increases each level after level 1
-	std::vector< std::vector<int> > per_primary;
 
 	int get(STAT stat) {
 		return current[stat];
@@ -246,6 +281,7 @@ public:
 	float flee_range;
 	int combat_style; // determines how the creature enters combat
 	int hero_stealth;
+	bool hero_in_aggro_zone; // set every frame by EnemyManager, see EnemyPerception
 	int turn_delay;
 	int turn_ticks;
 	bool in_combat;
@@ -259,9 +295,6 @@ public:
 	int flee_cooldown;
 	bool perfect_accuracy; // prevents misses & overhits; used for Event powers
 
-	std::vector<Event_Component> loot_table;
-	Point loot_count;
-
 	// for the teleport spell
 	bool teleportation;
 	FPoint teleport_destination;
@@ -273,12 +306,8 @@ public:
 	bool death_penalty;
 
 	// Campaign event interaction
-	std::string defeat_status;
-	std::string convert_status;
-	std::string quest_loot_requires_status;
-	std::string quest_loot_requires_not_status;
 	int quest_loot_id;
-	int first_defeat_loot;
+	bool loot_dropped; // the loot table is shared, so this keeps an enemy from dropping it twice
 
 	// player look options
 	std::string gfx_base; // folder in /images/avatar
@@ -288,15 +317,6 @@ public:
 
 	std::string animations;
 
-	// default sounds
-	std::vector<std::pair<std::string, std::string> > sfx_attack;
-	std::string sfx_step;
-	std::string sfx_hit;
-	std::string sfx_die;
-	std::string sfx_critdie;
-	std::string sfx_block;
-	std::string sfx_levelup;
-
 	// formula numbers
 	int max_spendable_stat_points;
 	int max_points_per_stat;
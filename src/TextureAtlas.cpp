@@ -0,0 +1,266 @@
+/*
+Copyright © 2016 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+#include "TextureAtlas.h"
+#include "RenderDevice.h"
+#include "SharedResources.h"
+
+#include <SDL_image.h>
+
+// 2048 is the largest texture size that practically every OpenGL ES 2 device supports
+const int ATLAS_PAGE_SIZE = 2048;
+
+// transparent gap between frames, so that texture filtering doesn't pick up the neighbouring frame
+const int ATLAS_PADDING = 1;
+
+AtlasShelf::AtlasShelf(int _y, int _height)
+	: y(_y)
+	, height(_height)
+	, used_width(0) {
+}
+
+AtlasPage::AtlasPage()
+	: image(NULL)
+	, used_height(0) {
+}
+
+/**
+ * Sorts frame indices by descending frame height, which keeps the shelves tightly filled
+ */
+class AtlasHeightCompare {
+public:
+	const std::vector<Rect>& frames;
+
+	explicit AtlasHeightCompare(const std::vector<Rect>& _frames)
+		: frames(_frames) {
+	}
+
+	bool operator()(size_t a, size_t b) const {
+		return frames[a].h > frames[b].h;
+	}
+};
+
+TextureAtlas::TextureAtlas() {
+}
+
+TextureAtlas::~TextureAtlas() {
+	for (size_t i = 0; i < pages.size(); ++i) {
+		pages[i].image->unref();
+	}
+}
+
+bool TextureAtlas::findFrame(const std::vector<Rect>& frames, const Rect& r, size_t& index) {
+	for (size_t i = 0; i < frames.size(); ++i) {
+		if (frames[i].x == r.x && frames[i].y == r.y && frames[i].w == r.w && frames[i].h == r.h) {
+			index = i;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Find a spot for every frame on the given page
+ * The page is only changed if all frames fit
+ */
+bool TextureAtlas::place(AtlasPage& page, std::vector<Rect>& rects, const std::vector<size_t>& order) {
+	std::vector<AtlasShelf> shelves = page.shelves;
+	int used_height = page.used_height;
+
+	for (size_t i = 0; i < order.size(); ++i) {
+		Rect& r = rects[order[i]];
+		const int w = r.w + ATLAS_PADDING;
+		const int h = r.h + ATLAS_PADDING;
+
+		if (w > ATLAS_PAGE_SIZE || h > ATLAS_PAGE_SIZE)
+			return false;
+
+		// use the lowest shelf that has room, to waste as little height as possible
+		size_t best = shelves.size();
+		for (size_t j = 0; j < shelves.size(); ++j) {
+			if (shelves[j].height >= h && shelves[j].used_width + w <= ATLAS_PAGE_SIZE) {
+				if (best == shelves.size() || shelves[j].height < shelves[best].height)
+					best = j;
+			}
+		}
+
+		if (best == shelves.size()) {
+			if (used_height + h > ATLAS_PAGE_SIZE)
+				return false;
+
+			shelves.push_back(AtlasShelf(used_height, h));
+			used_height += h;
+		}
+
+		r.x = shelves[best].used_width;
+		r.y = shelves[best].y;
+		shelves[best].used_width += w;
+	}
+
+	page.shelves = shelves;
+	page.used_height = used_height;
+	return true;
+}
+
+/**
+ * Copy the frames from the sprite-sheet file to their place on the page
+ */
+bool TextureAtlas::copyFrames(const std::string& filename, Image* page, const std::vector<Rect>& frames, const std::vector<Rect>& placed) {
+	SDL_Surface* cleanup = image_cache->load(mods->locate(filename));
+	if (!cleanup) {
+		logError("TextureAtlas: [%s] Couldn't load image: %s", filename.c_str(), IMG_GetError());
+		return false;
+	}
+
+	SDL_Surface* surface = SDL_ConvertSurfaceFormat(cleanup, SDL_PIXELFORMAT_ARGB8888, 0);
+	SDL_FreeSurface(cleanup);
+	if (!surface)
+		return false;
+
+	if (SDL_MUSTLOCK(surface))
+		SDL_LockSurface(surface);
+
+	std::vector<Color> pixels;
+	for (size_t i = 0; i < frames.size(); ++i) {
+		const Rect& src = frames[i];
+		pixels.assign(src.w * src.h, Color(0, 0, 0, 0));
+
+		for (int y = 0; y < src.h; ++y) {
+			const int sy = src.y + y;
+			if (sy < 0 || sy >= surface->h) continue;
+
+			const Uint32* row = reinterpret_cast<const Uint32*>(static_cast<const Uint8*>(surface->pixels) + sy * surface->pitch);
+			for (int x = 0; x < src.w; ++x) {
+				const int sx = src.x + x;
+				if (sx < 0 || sx >= surface->w) continue;
+
+				const Uint32 p = row[sx];
+				pixels[y * src.w + x] = Color(static_cast<Uint8>(p >> 16), static_cast<Uint8>(p >> 8), static_cast<Uint8>(p), static_cast<Uint8>(p >> 24));
+			}
+		}
+
+		page->writePixels(placed[i], pixels);
+	}
+
+	if (SDL_MUSTLOCK(surface))
+		SDL_UnlockSurface(surface);
+
+	SDL_FreeSurface(surface);
+	return true;
+}
+
+/**
+ * Pack the given frames of a sprite-sheet into the atlas
+ * On success, frames are changed to their location on the returned page. The
+ * caller owns a reference to the page. Returns NULL if the frames don't fit on
+ * a single page, in which case the sprite-sheet should be loaded as usual.
+ */
+Image* TextureAtlas::add(const std::string& filename, std::vector<Rect>& frames) {
+	std::vector<Rect> unique;
+	size_t index = 0;
+
+	for (size_t i = 0; i < frames.size(); ++i) {
+		if (frames[i].w > 0 && frames[i].h > 0 && !findFrame(unique, frames[i], index))
+			unique.push_back(frames[i]);
+	}
+
+	if (unique.empty())
+		return NULL;
+
+	AtlasEntry* entry = NULL;
+
+	// another animation set may have packed the same frames of this sprite-sheet already
+	for (size_t i = 0; i < entries.size() && !entry; ++i) {
+		if (entries[i].filename != filename)
+			continue;
+
+		bool has_all = true;
+		for (size_t j = 0; j < unique.size() && has_all; ++j) {
+			has_all = findFrame(entries[i].frames, unique[j], index);
+		}
+		if (has_all)
+			entry = &entries[i];
+	}
+
+	if (!entry) {
+		std::vector<size_t> order(unique.size());
+		for (size_t i = 0; i < order.size(); ++i) {
+			order[i] = i;
+		}
+		std::sort(order.begin(), order.end(), AtlasHeightCompare(unique));
+
+		std::vector<Rect> placed = unique;
+		size_t page_index = 0;
+		while (page_index < pages.size() && !place(pages[page_index], placed, order)) {
+			++page_index;
+		}
+
+		if (page_index == pages.size()) {
+			AtlasPage page;
+			if (!place(page, placed, order))
+				return NULL;
+
+			page.image = render_device->createImage(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE);
+			if (!page.image)
+				return NULL;
+
+			page.image->fillWithColor(Color(0, 0, 0, 0));
+			pages.push_back(page);
+		}
+
+		// the space stays reserved even if the image can't be loaded, but that is an error in the mod anyway
+		if (!copyFrames(filename, pages[page_index].image, unique, placed))
+			return NULL;
+
+		AtlasEntry new_entry;
+		new_entry.filename = filename;
+		new_entry.image = pages[page_index].image;
+		new_entry.frames = unique;
+		new_entry.placed = placed;
+		entries.push_back(new_entry);
+		entry = &entries.back();
+	}
+
+	for (size_t i = 0; i < frames.size(); ++i) {
+		if (findFrame(entry->frames, frames[i], index)) {
+			frames[i].x = entry->placed[index].x;
+			frames[i].y = entry->placed[index].y;
+		}
+	}
+
+	entry->image->ref();
+	return entry->image;
+}
+
+/**
+ * Free the pages that are no longer used by any animation set
+ */
+void TextureAtlas::cleanUp() {
+	for (size_t i = pages.size(); i > 0; --i) {
+		Image* image = pages[i-1].image;
+		if (image->getRefCount() > 1)
+			continue;
+
+		for (size_t j = entries.size(); j > 0; --j) {
+			if (entries[j-1].image == image)
+				entries.erase(entries.begin() + (j-1));
+		}
+
+		image->unref();
+		pages.erase(pages.begin() + (i-1));
+	}
+}
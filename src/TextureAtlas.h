@@ -0,0 +1,79 @@
+/*
+Copyright © 2016 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+/**
+ * class TextureAtlas
+ *
+ * Packs the frames of animation sprite-sheets into a few large shared images,
+ * so that enemies, avatar layers and loot drawn in the same frame mostly use
+ * the same texture and can be batched by the render device.
+ *
+ * Only the frame rectangles that are actually used are copied, using shelf
+ * packing. All frames of one sprite-sheet end up on the same page. A page is
+ * freed once none of the animation sets using it are loaded anymore.
+ */
+
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include "CommonIncludes.h"
+#include "Utils.h"
+
+class AtlasShelf {
+public:
+	int y;
+	int height;
+	int used_width;
+
+	AtlasShelf(int _y, int _height);
+};
+
+class AtlasPage {
+public:
+	Image* image;
+	std::vector<AtlasShelf> shelves;
+	int used_height;
+
+	AtlasPage();
+};
+
+class AtlasEntry {
+public:
+	std::string filename;
+	Image* image;
+	std::vector<Rect> frames; // location on the original sprite-sheet
+	std::vector<Rect> placed; // location on the atlas page
+};
+
+class TextureAtlas {
+private:
+	bool place(AtlasPage& page, std::vector<Rect>& rects, const std::vector<size_t>& order);
+	bool copyFrames(const std::string& filename, Image* page, const std::vector<Rect>& frames, const std::vector<Rect>& placed);
+	static bool findFrame(const std::vector<Rect>& frames, const Rect& r, size_t& index);
+
+	std::vector<AtlasPage> pages;
+	std::vector<AtlasEntry> entries;
+
+public:
+	TextureAtlas();
+	~TextureAtlas();
+
+	Image* add(const std::string& filename, std::vector<Rect>& frames);
+	void cleanUp();
+};
+
+#endif
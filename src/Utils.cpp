@@ -419,6 +419,20 @@ FPoint clampDistance(float range, const FPoint& src, const FPoint& target) {
 	return limit_target;
 }
 
+/**
+ * A point between prev (alpha 0) and cur (alpha 1)
+ * If the points are further apart than max_dist (e.g. after a teleport), cur is returned.
+ */
+FPoint interpolatePoint(const FPoint& prev, const FPoint& cur, float alpha, float max_dist) {
+	if (alpha >= 1 || calcDist(prev, cur) > max_dist)
+		return cur;
+
+	FPoint p;
+	p.x = prev.x + (cur.x - prev.x) * alpha;
+	p.y = prev.y + (cur.y - prev.y) * alpha;
+	return p;
+}
+
 /**
  * Compares two rectangles and returns true if they overlap
  */
@@ -53,6 +53,7 @@ class Rect {
 public:
 	int x, y, w, h;
 	Rect() : x(0), y(0), w(0), h(0) {}
+	Rect(int _x, int _y, int _w, int _h) : x(_x), y(_y), w(_w), h(_h) {}
 	explicit Rect(SDL_Rect _r) : x(_r.x), y(_r.y), w(_r.w), h(_r.h) {}
 	operator SDL_Rect() const {
 		SDL_Rect r;
@@ -86,6 +87,14 @@ public:
 	}
 };
 
+class LightSource {
+public:
+	FPoint pos;
+	float radius; // in map units, 0 means no light
+	Color color;
+	LightSource() : pos(), radius(0), color(255, 255, 255) {}
+};
+
 typedef enum {
 	ALIGN_TOPLEFT = 0,
 	ALIGN_TOP = 1,
@@ -177,6 +186,23 @@ public:
 	}
 };
 
+/**
+ * A requirement of an event, compiled from an Event_Component by EventManager::compileConditions()
+ * Statuses are referred to by their id from CampaignManager::getStatusID() instead of by name
+ */
+class EventCondition {
+public:
+	EVENT_COMPONENT_TYPE type;
+	int id; // status id, item id, currency amount or level, depending on type
+	std::string s; // class name
+
+	EventCondition()
+		: type(EC_NONE)
+		, id(0)
+		, s("") {
+	}
+};
+
 class EffectDef {
 public:
 	std::string id;
@@ -241,6 +267,7 @@ std::string getDurationString(const int duration, size_t precision = 2);
 std::string substituteVarsInString(const std::string &_s, Avatar* avatar = NULL);
 
 FPoint clampDistance(float range, const FPoint& src, const FPoint& target);
+FPoint interpolatePoint(const FPoint& prev, const FPoint& cur, float alpha, float max_dist);
 
 bool rectsOverlap(const Rect &a, const Rect &b);
 
@@ -31,6 +31,7 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include <dirent.h>
 #include <errno.h>
 #include <stdlib.h>
+#include <utime.h>
 
 /**
  * Check to see if a directory/folder exists
@@ -85,6 +86,27 @@ bool fileExists(const std::string &filename) {
 	return exists;
 }
 
+/**
+ * Get the size and last modification time of a file
+ * Returns false if the file can't be accessed
+ */
+bool getFileInfo(const std::string &filename, uint64_t &size, uint64_t &mtime) {
+	struct stat st;
+	if (stat(filename.c_str(), &st) != 0)
+		return false;
+
+	size = static_cast<uint64_t>(st.st_size);
+	mtime = static_cast<uint64_t>(st.st_mtime);
+	return true;
+}
+
+/**
+ * Set the modification time of an existing file to now
+ */
+bool touchFile(const std::string &filename) {
+	return utime(filename.c_str(), NULL) == 0;
+}
+
 /**
  * Returns a vector containing all filenames in a given folder with the given extension
  */
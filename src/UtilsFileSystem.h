@@ -26,11 +26,14 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #define UTILS_FILE_SYSTEM_H
 
 #include "CommonIncludes.h"
+#include <stdint.h>
 
 bool dirExists(const std::string &path);
 bool pathExists(const std::string &path);
 void createDir(const std::string &path);
 bool fileExists(const std::string &filename);
+bool getFileInfo(const std::string &filename, uint64_t &size, uint64_t &mtime);
+bool touchFile(const std::string &filename);
 int getFileList(const std::string &dir, const std::string &ext, std::vector<std::string> &files);
 int getDirList(const std::string &dir, std::vector<std::string> &dirs);
 
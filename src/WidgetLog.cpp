@@ -20,6 +20,7 @@ FLARE.  If not, see http://www.gnu.org/licenses/
  */
 
 #include "CommonIncludes.h"
+#include "RenderDevice.h"
 #include "SharedResources.h"
 #include "Widget.h"
 #include "WidgetLog.h"
@@ -29,16 +30,22 @@ WidgetLog::WidgetLog (int width, int height)
 	: scroll_box(new WidgetScrollBox(width, height))
 	, padding(4)
 	, max_messages(WIDGETLOG_MAX_MESSAGES)
+	, separator_sprite(NULL)
 	, updated(false)
 {
 	setFont(WIDGETLOG_FONT_REGULAR);
 	color_normal = font->getColor("menu_normal");
 	color_disabled = font->getColor("widget_disabled");
+
+	scroll_box->resizeVirtual(width, height);
 }
 
 WidgetLog::~WidgetLog () {
 	delete scroll_box;
 	clear();
+
+	if (separator_sprite)
+		delete separator_sprite;
 }
 
 void WidgetLog::setBasePos(int x, int y, ALIGNMENT a) {
@@ -66,53 +73,115 @@ void WidgetLog::logic() {
 	scroll_box->logic();
 }
 
+/**
+ * Messages are laid out newest first. Only the ones that overlap the visible
+ * part of the scroll box are drawn.
+ */
 void WidgetLog::render() {
 	if (updated) {
 		refresh();
 		updated = false;
 	}
+
+	const int cursor = scroll_box->getCursor();
+	int y = padding;
+
+	for (size_t i = messages.size(); i > 0; i--) {
+		if (y >= cursor + scroll_box->pos.h)
+			break;
+
+		if (separators[i-1]) {
+			if (y >= cursor)
+				renderSprite(separator_sprite, y, 1);
+			y += message_spacings[i-1];
+		}
+
+		if (y + message_heights[i-1] > cursor) {
+			if (!message_sprites[i-1])
+				renderMessage(i-1);
+			renderSprite(message_sprites[i-1], y, message_heights[i-1]);
+		}
+		y += message_heights[i-1] + message_spacings[i-1];
+	}
+
 	scroll_box->render();
 }
 
+/**
+ * Draw part of the log content at content position y, clipped to the visible area of the scroll box
+ */
+void WidgetLog::renderSprite(Sprite *sprite, int y, int h) {
+	if (!sprite) return;
+
+	const int cursor = scroll_box->getCursor();
+	h = std::max(h, sprite->getGraphicsHeight());
+
+	Rect clip;
+	clip.x = 0;
+	clip.y = std::max(0, cursor - y);
+	clip.w = sprite->getGraphicsWidth();
+	clip.h = std::min(y + h, cursor + scroll_box->pos.h) - (y + clip.y);
+	if (clip.h <= 0) return;
+
+	sprite->local_frame = scroll_box->local_frame;
+	sprite->setOffset(scroll_box->local_offset);
+	sprite->setClip(clip);
+	sprite->setDest(scroll_box->pos.x + padding, scroll_box->pos.y + y + clip.y - cursor);
+	render_device->render(sprite);
+}
+
+/**
+ * Rasterize a single message to its own image
+ */
+void WidgetLog::renderMessage(size_t index) {
+	const int content_width = scroll_box->pos.w-(padding*2);
+	if (content_width <= 0 || message_heights[index] <= 0) return;
+
+	setFont(styles[index]);
+
+	// leave room for the text shadow
+	Image *graphics = render_device->createImage(content_width+1, message_heights[index]+1);
+	if (!graphics) return;
+
+	font->renderShadowed(messages[index], 0, 0, JUSTIFY_LEFT, graphics, content_width, colors[index]);
+	message_sprites[index] = graphics->createSprite();
+	graphics->unref();
+}
+
 void WidgetLog::setPosition(int x, int y) {
 	scroll_box->pos.x = x;
 	scroll_box->pos.y = y;
 }
 
+/**
+ * Update the scrollable height. Only messages that haven't been measured yet are measured.
+ */
 void WidgetLog::refresh() {
-	int y,y2;
-	y = y2 = padding;
+	int y = padding;
 
 	int content_width = scroll_box->pos.w-(padding*2);
 
-	// Resize the scrollbox content area first
 	for (size_t i=0; i<messages.size(); i++) {
-		setFont(styles[i]);
-		Point size = font->calc_size(messages[i], content_width);
-		y += size.y+paragraph_spacing;
+		if (message_heights[i] < 0) {
+			setFont(styles[i]);
+			message_heights[i] = font->calc_size(messages[i], content_width).y;
+			message_spacings[i] = paragraph_spacing;
+		}
+		y += message_heights[i]+message_spacings[i];
 
 		if (separators[i])
-			y += paragraph_spacing+1;
+			y += message_spacings[i]+1;
 	}
 	y+=(padding*2);
-	scroll_box->resize(scroll_box->pos.w, y);
-
-	// Render messages into the scrollbox area
-	for (size_t i = messages.size(); i > 0; i--) {
-		setFont(styles[i-1]);
-		Point size = font->calc_size(messages[i-1], content_width);
-		Image* render_target = scroll_box->contents->getGraphics();
-
-		if (!separators.empty() && separators[i-1]) {
-			for (int j=padding; j<padding+content_width; ++j) {
-				render_target->drawPixel(j, y2, color_disabled);
-			}
+	scroll_box->resizeVirtual(scroll_box->pos.w, y);
 
-			y2 += paragraph_spacing;
+	if (!separator_sprite && content_width > 0) {
+		Image *graphics = render_device->createImage(content_width, 1);
+		if (graphics) {
+			graphics->writePixels(Rect(0, 0, content_width, 1), std::vector<Color>(content_width, color_disabled));
+			separator_sprite = graphics->createSprite();
+			graphics->unref();
 		}
-		font->renderShadowed(messages[i-1], padding, y2, JUSTIFY_LEFT, render_target, content_width, colors[i-1]);
-		y2 += size.y+paragraph_spacing;
-
 	}
 }
 
@@ -134,25 +203,42 @@ void WidgetLog::add(const std::string &s, bool prevent_spam, Color* color, int s
 		}
 		styles.push_back(style);
 		separators.resize(messages.size(), false);
+		message_sprites.push_back(NULL);
+		message_heights.push_back(-1);
+		message_spacings.push_back(0);
 		updated = true;
 	}
 }
 
 void WidgetLog::remove(unsigned msg_index) {
 	if (msg_index < messages.size()) {
+		if (message_sprites[msg_index])
+			delete message_sprites[msg_index];
+
 		messages.erase(messages.begin()+msg_index);
 		colors.erase(colors.begin()+msg_index);
 		styles.erase(styles.begin()+msg_index);
 		separators.erase(separators.begin()+msg_index);
+		message_sprites.erase(message_sprites.begin()+msg_index);
+		message_heights.erase(message_heights.begin()+msg_index);
+		message_spacings.erase(message_spacings.begin()+msg_index);
 		updated = true;
 	}
 }
 
 void WidgetLog::clear() {
+	for (size_t i=0; i<message_sprites.size(); i++) {
+		if (message_sprites[i])
+			delete message_sprites[i];
+	}
+
 	messages.clear();
 	colors.clear();
 	styles.clear();
 	separators.clear();
+	message_sprites.clear();
+	message_heights.clear();
+	message_spacings.clear();
 	updated = true;
 }
 
@@ -31,6 +31,7 @@ enum {
 	WIDGETLOG_FONT_BOLD = 1
 };
 
+class Sprite;
 class Widget;
 class WidgetScrollBox;
 
@@ -38,6 +39,8 @@ class WidgetLog : public Widget {
 private:
 	void refresh();
 	void setFont(int style);
+	void renderMessage(size_t index);
+	void renderSprite(Sprite *sprite, int y, int h);
 
 	WidgetScrollBox *scroll_box;
 	int line_height;
@@ -52,6 +55,12 @@ private:
 	std::vector<int> styles;
 	std::vector<bool> separators;
 
+	// each message is rasterized once when it's first shown; only visible messages are drawn
+	std::vector<Sprite*> message_sprites;
+	std::vector<int> message_heights;
+	std::vector<int> message_spacings; // paragraph_spacing of the message's font
+	Sprite *separator_sprite;
+
 	bool updated;
 
 public:
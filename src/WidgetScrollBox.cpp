@@ -26,7 +26,8 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include "WidgetScrollBox.h"
 
 WidgetScrollBox::WidgetScrollBox(int width, int height)
-	: contents(NULL) {
+	: contents(NULL)
+	, virtual_height(0) {
 	pos.x = pos.y = 0;
 	pos.w = width;
 	pos.h = height;
@@ -53,9 +54,9 @@ WidgetScrollBox::~WidgetScrollBox() {
 void WidgetScrollBox::setPos(int offset_x, int offset_y) {
 	Widget::setPos(offset_x, offset_y);
 
-	if (contents && scrollbar) {
+	if ((contents || virtual_height > 0) && scrollbar) {
 		scrollbar->refresh(pos.x+pos.w, pos.y, pos.h-scrollbar->pos_down.h, cursor,
-						   contents->getGraphicsHeight()-pos.h);
+						   getContentHeight()-pos.h);
 	}
 }
 
@@ -79,8 +80,8 @@ void WidgetScrollBox::scroll(int amount) {
 	if (cursor < 0) {
 		cursor = 0;
 	}
-	else if (contents && cursor > contents->getGraphicsHeight() - pos.h) {
-		cursor = contents->getGraphicsHeight() - pos.h;
+	else if ((contents || virtual_height > 0) && cursor > getContentHeight() - pos.h) {
+		cursor = getContentHeight() - pos.h;
 	}
 	refresh();
 }
@@ -90,8 +91,8 @@ void WidgetScrollBox::scrollTo(int amount) {
 	if (cursor < 0) {
 		cursor = 0;
 	}
-	else if (contents && cursor > contents->getGraphicsHeight() - pos.h) {
-		cursor = contents->getGraphicsHeight() - pos.h;
+	else if ((contents || virtual_height > 0) && cursor > getContentHeight() - pos.h) {
+		cursor = getContentHeight() - pos.h;
 	}
 	refresh();
 }
@@ -135,7 +136,7 @@ void WidgetScrollBox::logic(int x, int y) {
 	}
 
 	// check ScrollBar clicks
-	if (contents && contents->getGraphicsHeight() > pos.h && scrollbar) {
+	if (getContentHeight() > pos.h && scrollbar) {
 		switch (scrollbar->checkClick(mouse.x,mouse.y)) {
 			case 1:
 				scrollUp();
@@ -155,6 +156,7 @@ void WidgetScrollBox::logic(int x, int y) {
 void WidgetScrollBox::resize(int w, int h) {
 
 	pos.w = w;
+	virtual_height = 0;
 
 	if (pos.h > h) h = pos.h;
 
@@ -178,8 +180,34 @@ void WidgetScrollBox::resize(int w, int h) {
 	refresh();
 }
 
+/**
+ * Set the scrollable height without creating an image for the contents
+ * Used by widgets that only draw their visible part, like WidgetLog
+ */
+void WidgetScrollBox::resizeVirtual(int w, int h) {
+	pos.w = w;
+	virtual_height = std::max(h, pos.h);
+
+	if (contents) {
+		delete contents;
+		contents = NULL;
+	}
+
+	cursor = 0;
+	refresh();
+}
+
+int WidgetScrollBox::getContentHeight() {
+	if (virtual_height > 0)
+		return virtual_height;
+	else if (contents)
+		return contents->getGraphicsHeight();
+	else
+		return 0;
+}
+
 void WidgetScrollBox::refresh() {
-	if (update) {
+	if (update && virtual_height == 0) {
 		int h = pos.h;
 		if (contents) {
 			h = contents->getGraphicsHeight();
@@ -202,9 +230,9 @@ void WidgetScrollBox::refresh() {
 		}
 	}
 
-	if (contents && scrollbar) {
+	if ((contents || virtual_height > 0) && scrollbar) {
 		scrollbar->refresh(pos.x+pos.w, pos.y, pos.h-scrollbar->pos_down.h, cursor,
-						   contents->getGraphicsHeight()-pos.h);
+						   getContentHeight()-pos.h);
 	}
 }
 
@@ -230,7 +258,7 @@ void WidgetScrollBox::render() {
 		children[i]->render();
 	}
 
-	if (contents && contents->getGraphicsHeight() > pos.h && scrollbar) {
+	if (getContentHeight() > pos.h && scrollbar) {
 		scrollbar->local_frame = local_frame;
 		scrollbar->local_offset = local_offset;
 		scrollbar->render();
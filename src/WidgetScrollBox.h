@@ -41,8 +41,10 @@ public:
 	void logic();
 	void logic(int x, int y);
 	void resize(int w, int h);
+	void resizeVirtual(int w, int h);
 	void refresh();
 	void render();
+	int getContentHeight();
 
 	Sprite *contents;
 	bool update;
@@ -68,6 +70,9 @@ private:
 
 	int cursor;
 	WidgetScrollBar * scrollbar;
+
+	// if set, there is no contents image; the owner draws the visible part itself
+	int virtual_height;
 };
 
 #endif
@@ -98,6 +98,11 @@ static void init(const CmdLineArgs& cmd_line_args) {
 		Exit(1);
 	}
 
+	// must be after settings are loaded, since the cache can be disabled there
+	data_cache = new DataCache();
+	data_cache->load();
+	image_cache = new ImageCache();
+
 	save_load = new SaveLoad();
 	msg = new MessageEngine();
 	font = getFontEngine();
@@ -113,6 +118,9 @@ static void init(const CmdLineArgs& cmd_line_args) {
 	loadMiscSettings();
 	setStatNames();
 
+	// the software renderer draws with the job threads, so they must exist first
+	job_system = new JobSystem(JOB_THREADS);
+
 	// Create render Device and Rendering Context.
 	if (PlatformOptions.default_renderer != "")
 		render_device = getRenderDevice(PlatformOptions.default_renderer);
@@ -140,13 +148,38 @@ static float getSecondsElapsed(uint64_t prev_ticks, uint64_t now_ticks) {
 	return (static_cast<float>(now_ticks - prev_ticks) / static_cast<float>(SDL_GetPerformanceFrequency()));
 }
 
+/**
+ * How many frames per second should be rendered
+ * Uses max_render_fps if set, otherwise the refresh rate of the display.
+ */
+static int getRenderRate() {
+	int rate = MAX_RENDER_FPS;
+
+	if (rate <= 0) {
+		SDL_DisplayMode mode;
+		if (SDL_GetDesktopDisplayMode(0, &mode) == 0)
+			rate = mode.refresh_rate;
+	}
+
+	if (rate <= 0)
+		rate = MAX_FRAMES_PER_SEC;
+
+	return rate;
+}
+
 static void mainLoop () {
 	bool done = false;
 
-	float seconds_per_frame = 1.f/static_cast<float>(MAX_FRAMES_PER_SEC);
+	const uint64_t freq = SDL_GetPerformanceFrequency();
+
+	// the game logic runs at a fixed rate, while frames are rendered at the rate of the display
+	// the positions of moving objects are interpolated between logic frames
+	const uint64_t logic_interval = freq / MAX_FRAMES_PER_SEC;
+	const uint64_t render_interval = freq / getRenderRate();
 
-	uint64_t prev_ticks = SDL_GetPerformanceCounter();
 	uint64_t logic_ticks = SDL_GetPerformanceCounter();
+	uint64_t render_ticks = logic_ticks;
+	uint64_t prev_render_ticks = logic_ticks;
 
 	int last_fps = -1;
 
@@ -168,8 +201,10 @@ static void mainLoop () {
 			inpt->handle();
 
 			// Skip game logic when minimized on Mobile device
-			if (inpt->window_minimized && !inpt->window_restored)
+			if (inpt->window_minimized && !inpt->window_restored) {
+				logic_ticks = now_ticks + logic_interval;
 				break;
+			}
 
 			gswitch->logic();
 			inpt->resetScroll();
@@ -178,7 +213,7 @@ static void mainLoop () {
 			// Input done means the user closes the window.
 			done = gswitch->done || inpt->done;
 
-			logic_ticks += static_cast<uint64_t>(seconds_per_frame * static_cast<float>(SDL_GetPerformanceFrequency()));
+			logic_ticks += logic_interval;
 			loops++;
 
 			// Android and IOS only
@@ -193,52 +228,67 @@ static void mainLoop () {
 
 			// don't skip frames if the game is paused
 			if (gswitch->isPaused()) {
-				logic_ticks = now_ticks;
+				logic_ticks = now_ticks + logic_interval;
 				break;
 			}
 		}
 
-		render_device->blankScreen();
-		gswitch->render();
+		now_ticks = SDL_GetPerformanceCounter();
 
-		// display the FPS counter
-		if (last_fps != -1) {
-		    gswitch->showFPS(last_fps);
-		}
+		if (now_ticks >= render_ticks) {
+			// how far we are between the last logic frame (0) and the next one (1)
+			float interpolation = 1;
+			if (logic_ticks > now_ticks)
+				interpolation = std::max(0.f, 1.f - static_cast<float>(logic_ticks - now_ticks) / static_cast<float>(logic_interval));
 
-		render_device->commitFrame();
+			render_device->blankScreen();
+			gswitch->render(interpolation);
 
-		// calculate the FPS
-		// if the frame completed quickly, we estimate the delay here
-		float fps_delay;
-		if (getSecondsElapsed(prev_ticks, SDL_GetPerformanceCounter()) < seconds_per_frame) {
-			fps_delay = seconds_per_frame;
-		} else {
-			fps_delay = getSecondsElapsed(prev_ticks, SDL_GetPerformanceCounter());
-		}
-		if (fps_delay != 0) {
-			last_fps = static_cast<int>((1000.f / fps_delay) / 1000.f);
-		} else {
-			last_fps = -1;
-		}
+			// display the FPS counter
+			if (last_fps != -1) {
+				gswitch->showFPS(last_fps);
+			}
+
+			render_device->commitFrame();
 
-		// delay quick frames
-		// thanks to David Gow: https://davidgow.net/handmadepenguin/ch18.html
-		if (getSecondsElapsed(prev_ticks, SDL_GetPerformanceCounter()) < seconds_per_frame) {
-			int32_t delay_ms = static_cast<int32_t>((seconds_per_frame - getSecondsElapsed(prev_ticks, SDL_GetPerformanceCounter())) * 1000.f) - 1;
-			if (delay_ms > 0) {
-				SDL_Delay(delay_ms);
+			// calculate the FPS
+			now_ticks = SDL_GetPerformanceCounter();
+			float fps_delay = getSecondsElapsed(prev_render_ticks, now_ticks);
+			if (fps_delay != 0) {
+				last_fps = static_cast<int>(1.f / fps_delay);
+			} else {
+				last_fps = -1;
 			}
-			while (getSecondsElapsed(prev_ticks, SDL_GetPerformanceCounter()) < seconds_per_frame) {
-				// Waiting...
+			prev_render_ticks = now_ticks;
+
+			if (VSYNC) {
+				// commitFrame() waited for the display, so the next frame is started early enough to make the next refresh
+				render_ticks = now_ticks + render_interval / 2;
+			}
+			else {
+				// if a frame took too long, don't try to catch up
+				render_ticks = std::max(render_ticks + render_interval, now_ticks);
 			}
 		}
-		prev_ticks = SDL_GetPerformanceCounter();
+
+		// sleep until the next logic or render frame is due, instead of spinning
+		const uint64_t next_ticks = std::min(logic_ticks, render_ticks);
+		now_ticks = SDL_GetPerformanceCounter();
+		if (!done && next_ticks > now_ticks) {
+			uint32_t delay_ms = static_cast<uint32_t>((next_ticks - now_ticks) * 1000 / freq);
+			SDL_Delay(std::max(delay_ms, static_cast<uint32_t>(1)));
+		}
 	}
 }
 
 static void cleanup() {
 	delete gswitch;
+	delete job_system;
+
+	if (data_cache)
+		data_cache->save();
+	delete data_cache;
+	delete image_cache;
 
 	delete anim;
 	delete comb;